@@ -0,0 +1,95 @@
+#include "ffdc_buffer.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace openpower::common
+{
+
+namespace
+{
+
+/** @brief Throws the error of the last failed call */
+[[noreturn]] void throwError(const std::string& what)
+{
+    throw std::runtime_error(what + ": " + strerror(errno));
+}
+
+} // namespace
+
+FFDCBuffer::FFDCBuffer(std::string_view data) :
+    fd(memfd_create("ffdc", MFD_CLOEXEC | MFD_ALLOW_SEALING))
+{
+    if (fd == -1)
+    {
+        throwError("Unable to create FFDC file");
+    }
+
+    try
+    {
+        while (!data.empty())
+        {
+            auto rc = write(fd, data.data(), data.size());
+            if (rc == -1)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throwError("Failed to write FFDC file");
+            }
+            data.remove_prefix(rc);
+        }
+
+        if (fcntl(fd, F_ADD_SEALS,
+                  F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) ==
+            -1)
+        {
+            throwError("Failed to seal FFDC file");
+        }
+
+        if (lseek(fd, 0, SEEK_SET) == -1)
+        {
+            throwError("Failed to seek to the beginning of FFDC file");
+        }
+    }
+    catch (...)
+    {
+        close(fd);
+        throw;
+    }
+}
+
+FFDCBuffer::FFDCBuffer(FFDCBuffer&& other) noexcept :
+    fd(std::exchange(other.fd, -1))
+{}
+
+FFDCBuffer& FFDCBuffer::operator=(FFDCBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (fd != -1)
+        {
+            close(fd);
+        }
+        fd = std::exchange(other.fd, -1);
+    }
+    return *this;
+}
+
+FFDCBuffer::~FFDCBuffer()
+{
+    if (fd != -1)
+    {
+        close(fd);
+    }
+}
+
+} // namespace openpower::common
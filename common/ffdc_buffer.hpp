@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string_view>
+
+namespace openpower::common
+{
+
+/**
+ * @class FFDCBuffer
+ * @brief In-memory file holding FFDC (first failure data capture) data.
+ *
+ * The data is written to an anonymous file created by memfd_create, which
+ * is sealed against any further change and rewound, ready to be passed by
+ * file descriptor to CreatePELWithFFDCFiles. The file has no path, closing
+ * the descriptor releases it.
+ */
+class FFDCBuffer
+{
+  public:
+    FFDCBuffer() = delete;
+    FFDCBuffer(const FFDCBuffer&) = delete;
+    FFDCBuffer& operator=(const FFDCBuffer&) = delete;
+
+    /**
+     * @brief Creates the file and writes the data to it.
+     *
+     * @param[in] data - FFDC data
+     *
+     * Throws std::runtime_error if the file cannot be created or written.
+     */
+    explicit FFDCBuffer(std::string_view data);
+
+    FFDCBuffer(FFDCBuffer&& other) noexcept;
+    FFDCBuffer& operator=(FFDCBuffer&& other) noexcept;
+
+    /**
+     * @brief Closes the file.
+     */
+    ~FFDCBuffer();
+
+    /**
+     * @brief Returns the file descriptor, positioned at the start of the
+     * data and open for reading.
+     *
+     * @return file descriptor, -1 once moved from
+     */
+    int getFileDescriptor() const
+    {
+        return fd;
+    }
+
+  private:
+    /** @brief Descriptor of the in-memory file */
+    int fd = -1;
+};
+
+} // namespace openpower::common
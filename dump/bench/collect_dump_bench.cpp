@@ -0,0 +1,194 @@
+#include "sbe_consts.hpp"
+#include "sbe_dump_collector.hpp"
+#include "sim_chipop_backend.hpp"
+
+#include <stdlib.h>
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <CLI/Formatter.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Times SbeDumpCollector::collectDump end to end over a simulated topology.
+ */
+int main(int argc, char** argv)
+{
+    using namespace openpower::dump;
+    using namespace openpower::dump::sbe_chipop;
+    using namespace openpower::dump::SBE;
+    namespace exception = openpower::phal::exception;
+
+    CLI::App app{"Dump collection benchmark", "collect-dump-bench"};
+
+    SimTopology topology;
+    OcmbConcurrency ocmbConcurrency;
+    size_t workers = 0;
+    std::string compression = "none";
+    int type = SBE_DUMP_TYPE_HARDWARE;
+    uint32_t failingUnit = 0;
+    unsigned iterations = 3;
+    uint32_t procLatencyMs = 100;
+    uint32_t ocmbLatencyMs = 50;
+    std::string error;
+    std::vector<uint32_t> errorProcs;
+    uint32_t slowLatencyMs = 60000;
+    std::vector<uint32_t> slowProcs;
+    unsigned deadline = 0;
+
+    app.add_option("--procs", topology.procs, "Number of procs")
+        ->check(CLI::Range(1, 16));
+    app.add_option("--ocmbs", topology.ocmbsPerProc,
+                   "Number of Odyssey OCMBs per proc")
+        ->check(CLI::Range(0, 16));
+    app.add_option("--ocmbs-per-link", topology.ocmbsPerLink,
+                   "Number of OCMBs sharing each FSI link")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--ocmb-concurrency", ocmbConcurrency.perProc,
+                   "Maximum OCMB dumps collected at once on each proc")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--ocmb-link-concurrency", ocmbConcurrency.perLink,
+                   "Maximum OCMB dumps collected at once on each FSI link")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--workers", workers,
+                   "Number of collection threads, 0 to size from the cores");
+    app.add_option("--compress", compression,
+                   "Compression applied to the dump files as they are written")
+        ->check(CLI::IsMember({"none", "gzip"}));
+    app.add_option("--type, -t", type, "Type of the dump")
+        ->check(CLI::IsMember({SBE_DUMP_TYPE_HARDWARE, SBE_DUMP_TYPE_HOSTBOOT,
+                               SBE_DUMP_TYPE_PERFORMANCE, SBE_DUMP_TYPE_SBE,
+                               SBE_DUMP_TYPE_MSBE}));
+    app.add_option("--failingunit, -f", failingUnit, "ID of the failing unit");
+    app.add_option("--iterations, -n", iterations, "Number of collections")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--proc-size", topology.proc.dumpSize,
+                   "Dump size of each proc in bytes");
+    app.add_option("--proc-fastarray-size", topology.proc.fastArraySize,
+                   "Fastarray size of each proc in bytes");
+    app.add_option("--proc-latency", procLatencyMs,
+                   "Chip-op latency of each proc in milliseconds");
+    app.add_option("--ocmb-size", topology.ocmb.dumpSize,
+                   "Dump size of each OCMB in bytes");
+    app.add_option("--ocmb-latency", ocmbLatencyMs,
+                   "Chip-op latency of each OCMB in milliseconds");
+    app.add_option("--error", error, "Error raised by the failing procs")
+        ->check(CLI::IsMember({"timeout", "failed", "not-allowed",
+                               "internal-ffdc", "no-ffdc"}));
+    app.add_option("--error-procs", errorProcs,
+                   "Positions of the procs raising the error");
+    app.add_option("--slow-procs", slowProcs,
+                   "Positions of the procs whose chip-ops hang");
+    app.add_option("--slow-latency", slowLatencyMs,
+                   "Chip-op latency of the slow procs in milliseconds");
+    app.add_option("--deadline", deadline,
+                   "Seconds allowed for each collection, 0 for no limit");
+
+    CLI11_PARSE(app, argc, argv);
+
+    topology.proc.latency = std::chrono::milliseconds(procLatencyMs);
+    topology.ocmb.latency = std::chrono::milliseconds(ocmbLatencyMs);
+
+    if (!error.empty())
+    {
+        const std::map<std::string, exception::ERR_TYPE> errors = {
+            {"timeout", exception::SBE_CMD_TIMEOUT},
+            {"failed", exception::SBE_CMD_FAILED},
+            {"not-allowed", exception::SBE_CHIPOP_NOT_ALLOWED},
+            {"internal-ffdc", exception::SBE_INTERNAL_FFDC_DATA},
+            {"no-ffdc", exception::SBE_FFDC_NO_DATA}};
+        for (auto proc : errorProcs)
+        {
+            auto config = topology.proc;
+            config.dumpError = errors.at(error);
+            config.threadStopError = errors.at(error);
+            topology.chips[{SBETypes::PROC, proc}] = config;
+        }
+    }
+
+    for (auto proc : slowProcs)
+    {
+        auto config = topology.chips.contains({SBETypes::PROC, proc})
+                          ? topology.chips.at({SBETypes::PROC, proc})
+                          : topology.proc;
+        config.latency = std::chrono::milliseconds(slowLatencyMs);
+        topology.chips[{SBETypes::PROC, proc}] = config;
+    }
+
+    std::vector<double> samples;
+    TimingSummary timing;
+    for (unsigned i = 0; i < iterations; i++)
+    {
+        char dirTemplate[] = "/tmp/collect_dump_bench.XXXXXX";
+        if (mkdtemp(dirTemplate) == nullptr)
+        {
+            std::cerr << "Failed to create the dump directory\n";
+            return EXIT_FAILURE;
+        }
+        std::filesystem::path dumpDir{dirTemplate};
+
+        SbeDumpCollector collector(
+            std::make_unique<SimChipOpBackend>(topology));
+        collector.setOcmbConcurrency(ocmbConcurrency);
+        collector.setWorkerCount(workers);
+        collector.setCompression(compression == "gzip"
+                                     ? DumpCompression::gzip
+                                     : DumpCompression::none);
+
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            collector.collectDump(type, i + 1, failingUnit, dumpDir,
+                                  std::chrono::seconds(deadline));
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to collect dump: " << e.what() << "\n";
+        }
+        auto end = std::chrono::steady_clock::now();
+        timing = collector.lastTiming();
+
+        samples.push_back(
+            std::chrono::duration<double, std::milli>(end - start).count());
+        std::filesystem::remove_all(dumpDir);
+    }
+
+    auto [minIt, maxIt] = std::minmax_element(samples.begin(), samples.end());
+    double total = 0;
+    for (auto sample : samples)
+    {
+        total += sample;
+    }
+
+    std::cout << std::format(
+        "type={} procs={} ocmbs={} ocmb-concurrency={}/{} workers={} "
+        "compress={} deadline={}s iterations={} min={:.1f}ms avg={:.1f}ms "
+        "max={:.1f}ms\n",
+        type, topology.procs, topology.ocmbsPerProc, ocmbConcurrency.perProc,
+        ocmbConcurrency.perLink, workers, compression, deadline, iterations,
+        *minIt, total / samples.size(), *maxIt);
+
+    // Phase latencies of the last iteration
+    for (size_t i = 0; i < timingPhaseCount; i++)
+    {
+        const auto& histogram = timing.phases[i];
+        if (histogram.count != 0)
+        {
+            std::cout << std::format(
+                "  {}: count={} p50={}us p99={}us max={}us\n",
+                timingPhaseName(static_cast<TimingPhase>(i)), histogram.count,
+                histogram.percentile(50), histogram.percentile(99),
+                histogram.maxUs);
+        }
+    }
+
+    return 0;
+}
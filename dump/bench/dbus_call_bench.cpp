@@ -0,0 +1,68 @@
+#include "dump_utils.hpp"
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <CLI/Formatter.hpp>
+#include <sdbusplus/bus.hpp>
+
+#include <chrono>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+/** @brief Round trip to the bus daemon */
+void ping(sdbusplus::bus_t& bus)
+{
+    auto method = bus.new_method_call("org.freedesktop.DBus",
+                                      "/org/freedesktop/DBus",
+                                      "org.freedesktop.DBus.Peer", "Ping");
+    bus.call_noreply(method);
+}
+
+/** @brief Average time of a call in microseconds */
+double timeCalls(unsigned iterations, const std::function<void()>& call)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++)
+    {
+        call();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() /
+           iterations;
+}
+
+} // namespace
+
+/**
+ * Times a D-Bus call made on a new default connection, as the dump code
+ * used to, and on the shared connection of the thread.
+ */
+int main(int argc, char** argv)
+{
+    using namespace openpower::dump;
+
+    CLI::App app{"D-Bus call benchmark", "dbus-call-bench"};
+
+    unsigned iterations = 1000;
+    app.add_option("--iterations, -n", iterations, "Number of calls")
+        ->check(CLI::PositiveNumber);
+
+    CLI11_PARSE(app, argc, argv);
+
+    auto perCall = timeCalls(iterations, []() {
+        auto bus = sdbusplus::bus::new_default();
+        ping(bus);
+    });
+    auto shared = timeCalls(iterations, []() { ping(util::getBus()); });
+
+    std::cout << std::format(
+        "iterations={} new-connection={:.1f}us shared-connection={:.1f}us\n",
+        iterations, perCall, shared);
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "dump_header.hpp"
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <CLI/Formatter.hpp>
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Times building the system dump and BMC dump headers.
+ */
+int main(int argc, char** argv)
+{
+    using namespace openpower::dump::header;
+
+    CLI::App app{"Dump header benchmark", "dump-header-bench"};
+
+    std::string type = "system";
+    unsigned iterations = 100000;
+
+    app.add_option("--type", type, "Type of the dump")
+        ->check(CLI::IsMember({"system", "bmc", "faultdata"}));
+    app.add_option("--iterations, -n", iterations, "Number of headers built")
+        ->check(CLI::PositiveNumber);
+
+    CLI11_PARSE(app, argc, argv);
+
+    OpDumpHeaderInfo opInfo{"00000001", "50000001", "1234567", "9105-22A",
+                            "server", "20240101123456"};
+    BmcDumpHeaderInfo bmcInfo;
+    bmcInfo.faultData = (type == "faultdata");
+    bmcInfo.dumpId = "00000001";
+    bmcInfo.eid = "50000001";
+    bmcInfo.serial = "1234567";
+    bmcInfo.bmcSerial = "Y1234567890A";
+    bmcInfo.model = "9105-22A";
+    bmcInfo.timestamp = "20240101123456";
+    bmcInfo.originatorType = "Internal";
+    bmcInfo.originatorId = "bmc";
+    bmcInfo.archiveSize = 64 * 1024 * 1024;
+
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++)
+    {
+        std::vector<uint8_t> headerData;
+        if (type == "system")
+        {
+            headerData = buildOpDumpHeader(opInfo);
+            setOpDumpSizes(headerData, bmcInfo.archiveSize);
+        }
+        else
+        {
+            headerData = buildBmcDumpHeader(bmcInfo);
+        }
+        checksum += headerData[i % headerData.size()];
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double total =
+        std::chrono::duration<double, std::micro>(end - start).count();
+    std::cout << std::format(
+        "type={} iterations={} avg={:.3f}us checksum={}\n", type, iterations,
+        total / iterations, checksum);
+
+    return 0;
+}
@@ -0,0 +1,370 @@
+#include "collection_timing.hpp"
+#include "dump_job_queue.hpp"
+#include "dump_monitor.hpp"
+#include "dump_utils.hpp"
+#include "fake_services.hpp"
+#include "sbe_consts.hpp"
+#include "sbe_dump_collector.hpp"
+#include "sim_chipop_backend.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <CLI/Formatter.hpp>
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdeventplus/clock.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/time.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace
+{
+
+using namespace openpower::dump;
+using Clock = std::chrono::steady_clock;
+
+constexpr auto progressInterface = "xyz.openbmc_project.Common.Progress";
+constexpr auto statusCompleted =
+    "xyz.openbmc_project.Common.Progress.OperationStatus.Completed";
+constexpr auto statusFailed =
+    "xyz.openbmc_project.Common.Progress.OperationStatus.Failed";
+
+/**
+ * @brief Replays bursts of dump requests through the dump manager and
+ * measures how long the entries take to complete.
+ */
+class BurstDriver
+{
+  public:
+    BurstDriver(sdbusplus::bus_t& bus, sdeventplus::Event& event,
+                std::string dumpType, uint32_t failingUnit, unsigned bursts,
+                unsigned burstSize) :
+        bus(bus), event(event), dumpType(std::move(dumpType)),
+        failingUnit(failingUnit), bursts(bursts), burstSize(burstSize),
+        added(bus,
+              sdbusplus::match_rules::interfacesAdded(
+                  "/xyz/openbmc_project/dump") +
+                  sdbusplus::match_rules::sender(fake::dumpManagerBusName),
+              [this](sdbusplus::message_t& msg) { entryAdded(msg); }),
+        changed(bus,
+                sdbusplus::match_rules::propertiesChangedNamespace(
+                    "/xyz/openbmc_project/dump/system", progressInterface),
+                [this](sdbusplus::message_t& msg) { statusChanged(msg); })
+    {}
+
+    /** @brief Requests the dumps of the next burst */
+    void startBurst()
+    {
+        if (started == 0)
+        {
+            start = Clock::now();
+        }
+        started++;
+        for (unsigned i = 0; i < burstSize; i++)
+        {
+            util::DumpCreateParams params = {
+                {"com.ibm.Dump.Create.CreateParameters.DumpType", dumpType},
+                {"com.ibm.Dump.Create.CreateParameters.ErrorLogId",
+                 uint64_t{i}},
+                {"com.ibm.Dump.Create.CreateParameters.FailingUnitId",
+                 uint64_t{failingUnit}}};
+            auto method = bus.new_method_call(
+                fake::dumpManagerBusName, "/xyz/openbmc_project/dump/system",
+                "xyz.openbmc_project.Dump.Create", "CreateDump");
+            method.append(params);
+            auto path = bus.call(method).unpack<sdbusplus::object_path>();
+            requested.insert(path.str);
+        }
+    }
+
+    /** @brief Entries done, dumps requested by the collections included */
+    size_t completed = 0;
+    size_t failed = 0;
+
+    /** @brief Entries requested by the collections */
+    size_t nested = 0;
+
+    /** @brief InterfacesAdded to Completed latencies */
+    LatencyHistogram latency;
+
+    /** @brief Time from the first request to the last completion */
+    Clock::duration elapsed{};
+
+  private:
+    sdbusplus::bus_t& bus;
+    sdeventplus::Event& event;
+    const std::string dumpType;
+    const uint32_t failingUnit;
+    const unsigned bursts;
+    const unsigned burstSize;
+
+    /** @brief Entries requested by the driver */
+    std::set<std::string> requested;
+
+    /** @brief Entries in progress and the time they were announced */
+    std::map<std::string, Clock::time_point> inProgress;
+
+    /** @brief Bursts started */
+    unsigned started = 0;
+
+    /** @brief Time of the first request */
+    Clock::time_point start;
+
+    sdbusplus::match_t added;
+    sdbusplus::match_t changed;
+
+    void entryAdded(sdbusplus::message_t& msg)
+    {
+        sdbusplus::object_path path;
+        InterfaceMap interfaces;
+        msg.read(path, interfaces);
+        inProgress.emplace(path.str, Clock::now());
+        if (!requested.contains(path.str))
+        {
+            nested++;
+        }
+    }
+
+    void statusChanged(sdbusplus::message_t& msg)
+    {
+        std::string interface;
+        std::map<std::string, std::variant<std::string, uint64_t>> properties;
+        msg.read(interface, properties);
+        auto status = properties.find("Status");
+        if (status == properties.end())
+        {
+            return;
+        }
+        const auto& value = std::get<std::string>(status->second);
+        auto entry = inProgress.find(msg.get_path());
+        if (entry == inProgress.end() ||
+            (value != statusCompleted && value != statusFailed))
+        {
+            return;
+        }
+
+        auto now = Clock::now();
+        latency.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                           now - entry->second)
+                           .count());
+        (value == statusCompleted ? completed : failed)++;
+        inProgress.erase(entry);
+
+        // The next burst starts once every entry of the previous one, and
+        // the dumps they requested, are done
+        if (inProgress.empty())
+        {
+            elapsed = now - start;
+            if (started < bursts)
+            {
+                startBurst();
+            }
+            else
+            {
+                event.exit(0);
+            }
+        }
+    }
+};
+
+} // namespace
+
+/**
+ * Measures the dump rate and latency of the monitor over fake D-Bus
+ * services and a simulated system. The services run in a child process on
+ * the same bus, standing in for the dump manager, the logging service and
+ * the mapper.
+ */
+int main(int argc, char** argv)
+{
+    using namespace openpower::dump::sbe_chipop;
+    using namespace openpower::dump::SBE;
+    namespace exception = openpower::phal::exception;
+
+    CLI::App app{"Dump pipeline benchmark", "dump-pipeline-bench"};
+
+    std::string type = "hardware";
+    unsigned bursts = 3;
+    unsigned burstSize = 4;
+    uint32_t failingUnit = 0;
+    SimTopology topology;
+    uint32_t procLatencyMs = 100;
+    std::vector<uint32_t> timeoutProcs;
+    unsigned pelLatencyMs = 20;
+    size_t maxJobs = 2;
+    size_t typeJobs = 1;
+    unsigned timeoutS = 600;
+
+    app.add_option("--type, -t", type, "Type of the requested dumps")
+        ->check(CLI::IsMember({"hardware", "hostboot", "sbe"}));
+    app.add_option("--bursts", bursts, "Number of bursts")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--burst-size", burstSize, "Dumps requested by each burst")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--failingunit, -f", failingUnit, "ID of the failing unit");
+    app.add_option("--procs", topology.procs, "Number of procs")
+        ->check(CLI::Range(1, 16));
+    app.add_option("--ocmbs", topology.ocmbsPerProc,
+                   "Number of Odyssey OCMBs per proc")
+        ->check(CLI::Range(0, 16));
+    app.add_option("--proc-latency", procLatencyMs,
+                   "Chip-op latency of each proc in milliseconds");
+    app.add_option("--timeout-procs", timeoutProcs,
+                   "Positions of the procs whose chip-ops time out, each "
+                   "timeout logs a PEL and requests an SBE dump");
+    app.add_option("--pel-latency", pelLatencyMs,
+                   "Time taken to create each PEL in milliseconds");
+    app.add_option("--max-jobs", maxJobs,
+                   "Maximum dump collections running at once")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--type-jobs", typeJobs,
+                   "Maximum collections of each dump type running at once")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--timeout", timeoutS, "Longest run in seconds")
+        ->check(CLI::PositiveNumber);
+
+    CLI11_PARSE(app, argc, argv);
+
+    char dirTemplate[] = "/tmp/dump_pipeline_bench.XXXXXX";
+    if (mkdtemp(dirTemplate) == nullptr)
+    {
+        std::cerr << "Failed to create the dump directory\n";
+        return EXIT_FAILURE;
+    }
+    std::filesystem::path dumpDir{dirTemplate};
+
+    // The services are forked before this process creates any thread, event
+    // loop or bus connection
+    int ready[2];
+    if (pipe2(ready, O_CLOEXEC) == -1)
+    {
+        std::cerr << "Failed to create the ready pipe\n";
+        return EXIT_FAILURE;
+    }
+    pid_t services = fork();
+    if (services == -1)
+    {
+        std::cerr << "Failed to start the fake services\n";
+        return EXIT_FAILURE;
+    }
+    if (services == 0)
+    {
+        close(ready[0]);
+        fake::FakeServiceConfig config;
+        config.dumpDir = dumpDir;
+        config.pelLatency = std::chrono::milliseconds(pelLatencyMs);
+        _exit(fake::runFakeServices(config, [&ready]() {
+            char byte = 0;
+            if (write(ready[1], &byte, 1) == -1)
+            {
+                _exit(EXIT_FAILURE);
+            }
+            close(ready[1]);
+        }));
+    }
+    close(ready[1]);
+    char byte = 0;
+    bool servicesReady = read(ready[0], &byte, 1) == 1;
+    close(ready[0]);
+    if (!servicesReady)
+    {
+        std::cerr << "Failed to start the fake services\n";
+        waitpid(services, nullptr, 0);
+        return EXIT_FAILURE;
+    }
+
+    // The monitor reaps its collection processes through the event loop
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &mask, nullptr);
+
+    topology.proc.latency = std::chrono::milliseconds(procLatencyMs);
+    for (auto proc : timeoutProcs)
+    {
+        auto config = topology.proc;
+        config.dumpError = exception::SBE_CMD_TIMEOUT;
+        topology.chips[{SBETypes::PROC, proc}] = config;
+    }
+
+    const std::map<std::string, std::string> dumpTypes = {
+        {"hardware", "com.ibm.Dump.Create.DumpType.Hardware"},
+        {"hostboot", "com.ibm.Dump.Create.DumpType.Hostboot"},
+        {"sbe", "com.ibm.Dump.Create.DumpType.SBE"}};
+
+    int exitCode = EXIT_SUCCESS;
+    {
+        auto event = sdeventplus::Event::get_default();
+        DumpJobQueue jobQueue({{SBE_DUMP_TYPE_HARDWARE, typeJobs},
+                               {SBE_DUMP_TYPE_HOSTBOOT, typeJobs},
+                               {SBE_DUMP_TYPE_SBE, typeJobs},
+                               {SBE_DUMP_TYPE_MSBE, typeJobs}},
+                              maxJobs);
+        DumpMonitor monitor(std::move(jobQueue),
+                            std::make_unique<SbeDumpCollector>(
+                                std::make_unique<SimChipOpBackend>(topology)));
+        monitor.setDumpDir(dumpDir);
+
+        BurstDriver driver(util::getBus(), event, dumpTypes.at(type),
+                           failingUnit, bursts, burstSize);
+
+        using Timer =
+            sdeventplus::source::Time<sdeventplus::ClockId::Monotonic>;
+        auto clock = sdeventplus::Clock<sdeventplus::ClockId::Monotonic>(event);
+        Timer deadline(event, clock.now() + std::chrono::seconds(timeoutS),
+                       std::chrono::milliseconds(1),
+                       [&event](Timer&, Timer::TimePoint) {
+                           std::cerr << "The dumps did not complete in time\n";
+                           event.exit(EXIT_FAILURE);
+                       });
+
+        try
+        {
+            driver.startBurst();
+            exitCode = monitor.run();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to run the dump pipeline: " << e.what()
+                      << "\n";
+            exitCode = EXIT_FAILURE;
+        }
+
+        auto minutes =
+            std::chrono::duration<double, std::ratio<60>>(driver.elapsed)
+                .count();
+        auto done = driver.completed + driver.failed;
+        std::cout << std::format(
+            "type={} bursts={} burst-size={} procs={} timeout-procs={} "
+            "pel-latency={}ms completed={} failed={} nested={} "
+            "dumps/min={:.1f} latency p50={}ms p99={}ms max={}ms\n",
+            type, bursts, burstSize, topology.procs, timeoutProcs.size(),
+            pelLatencyMs, driver.completed, driver.failed, driver.nested,
+            minutes > 0 ? done / minutes : 0.0,
+            driver.latency.percentile(50) / 1000,
+            driver.latency.percentile(99) / 1000,
+            driver.latency.maxUs / 1000);
+    }
+
+    kill(services, SIGTERM);
+    waitpid(services, nullptr, 0);
+    std::filesystem::remove_all(dumpDir);
+    return exitCode;
+}
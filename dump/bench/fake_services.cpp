@@ -0,0 +1,489 @@
+#include "fake_services.hpp"
+
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <systemd/sd-bus.h>
+#include <unistd.h>
+
+#include <sdbusplus/server/manager.hpp>
+#include <sdeventplus/clock.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+#include <format>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace openpower::dump::fake
+{
+
+namespace
+{
+
+constexpr auto dumpRootPath = "/xyz/openbmc_project/dump";
+constexpr auto systemDumpPath = "/xyz/openbmc_project/dump/system";
+constexpr auto bmcDumpPath = "/xyz/openbmc_project/dump/bmc";
+constexpr auto dumpCreateInterface = "xyz.openbmc_project.Dump.Create";
+constexpr auto progressInterface = "xyz.openbmc_project.Common.Progress";
+constexpr auto loggingObjectPath = "/xyz/openbmc_project/logging";
+constexpr auto opLoggingInterface = "org.open_power.Logging.PEL";
+constexpr auto entryInterface = "xyz.openbmc_project.Logging.Entry";
+constexpr auto opEntryInterface = "org.open_power.Logging.PEL.Entry";
+constexpr auto mapperObjectPath = "/xyz/openbmc_project/object_mapper";
+constexpr auto mapperInterface = "xyz.openbmc_project.ObjectMapper";
+
+constexpr auto statusInProgress =
+    "xyz.openbmc_project.Common.Progress.OperationStatus.InProgress";
+constexpr auto statusCompleted =
+    "xyz.openbmc_project.Common.Progress.OperationStatus.Completed";
+
+constexpr auto paramDumpType = "com.ibm.Dump.Create.CreateParameters.DumpType";
+constexpr auto paramErrorLogId =
+    "com.ibm.Dump.Create.CreateParameters.ErrorLogId";
+constexpr auto paramFailingUnitId =
+    "com.ibm.Dump.Create.CreateParameters.FailingUnitId";
+
+using CreateParams = std::map<std::string, std::variant<std::string, uint64_t>>;
+
+/** @brief Entry interface and id type of a requested dump type */
+struct DumpTypeInfo
+{
+    const char* interface;
+    uint32_t idType;
+};
+
+/* @brief Dump types of CreateDump, the id type is what the monitor
+ * derives the SBE_DUMP_TYPE_* from */
+const std::map<std::string, DumpTypeInfo> dumpTypes = {
+    {"com.ibm.Dump.Create.DumpType.Hardware",
+     {"com.ibm.Dump.Entry.Hardware", 0}},
+    {"com.ibm.Dump.Create.DumpType.Hostboot",
+     {"com.ibm.Dump.Entry.Hostboot", 2}},
+    {"com.ibm.Dump.Create.DumpType.SBE", {"com.ibm.Dump.Entry.SBE", 3}},
+    {"com.ibm.Dump.Create.DumpType.MemoryBufferSBE",
+     {"com.ibm.Dump.Entry.SBE", 4}},
+};
+
+/* @brief Services of the paths known to the mapper */
+const std::pair<std::string, const char*> servicePaths[] = {
+    {dumpRootPath, dumpManagerBusName},
+    {loggingObjectPath, loggingBusName},
+};
+
+/** @brief Reads an integer create parameter, 0 if absent */
+uint32_t uintParam(const CreateParams& params, const char* name)
+{
+    auto it = params.find(name);
+    if (it == params.end())
+    {
+        return 0;
+    }
+    auto value = std::get_if<uint64_t>(&it->second);
+    return value ? static_cast<uint32_t>(*value) : 0;
+}
+
+} // namespace
+
+const sdbusplus::vtable::vtable_t ObjectMapper::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::method("GetObject", "sas", "a{sas}", getObject),
+    sdbusplus::vtable::end()};
+
+ObjectMapper::ObjectMapper(sdbusplus::bus_t& bus) :
+    mapper(bus, mapperObjectPath, mapperInterface, vtable, this)
+{}
+
+int ObjectMapper::getObject(sd_bus_message* msg, void*, sd_bus_error* error)
+{
+    sdbusplus::message_t call{msg};
+    std::string path;
+    std::vector<std::string> interfaces;
+    try
+    {
+        call.read(path, interfaces);
+    }
+    catch (const std::exception&)
+    {
+        return sd_bus_error_set(error, SD_BUS_ERROR_INVALID_ARGS,
+                                "Invalid arguments");
+    }
+
+    for (const auto& [root, service] : servicePaths)
+    {
+        if (path == root || path.starts_with(root + "/"))
+        {
+            std::map<std::string, std::vector<std::string>> object = {
+                {service, interfaces}};
+            auto reply = call.new_method_return();
+            reply.append(object);
+            reply.method_return();
+            return 1;
+        }
+    }
+    return sd_bus_error_set(error,
+                            "xyz.openbmc_project.Common.Error.ResourceNotFound",
+                            "No service hosts the path");
+}
+
+const sdbusplus::vtable::vtable_t Logging::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::method("CreatePELWithFFDCFiles", "ssa{ss}a(ssyyh)",
+                              "(uu)", createPEL),
+    sdbusplus::vtable::end()};
+
+const sdbusplus::vtable::vtable_t Logging::entryVtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("EventId", "s", getEntryProperty,
+                                sdbusplus::vtable::property_::const_),
+    sdbusplus::vtable::end()};
+
+const sdbusplus::vtable::vtable_t Logging::pelEntryVtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("PlatformLogID", "u", getEntryProperty,
+                                sdbusplus::vtable::property_::const_),
+    sdbusplus::vtable::end()};
+
+Logging::Logging(sdbusplus::bus_t& bus, const sdeventplus::Event& event,
+                 std::chrono::milliseconds latency) :
+    bus(bus), event(event), latency(latency),
+    logging(bus, loggingObjectPath, opLoggingInterface, vtable, this)
+{}
+
+int Logging::createPEL(sd_bus_message* msg, void* context,
+                       sd_bus_error* error)
+{
+    auto logging = static_cast<Logging*>(context);
+    sdbusplus::message_t call{msg};
+    std::string message;
+    std::string severity;
+    std::map<std::string, std::string> additionalData;
+    try
+    {
+        call.read(message, severity, additionalData);
+    }
+    catch (const std::exception&)
+    {
+        return sd_bus_error_set(error, SD_BUS_ERROR_INVALID_ARGS,
+                                "Invalid arguments");
+    }
+
+    // The entry exists as soon as the PEL is requested, its ids are
+    // returned once the PEL is created
+    auto logId = static_cast<uint32_t>(logging->entries.size() + 1);
+    auto path = std::format("{}/entry/{}", loggingObjectPath, logId);
+    auto& entry = logging->entries[logId];
+    entry.logId = logId;
+    entry.pelId = 0x50000000 | logId;
+    entry.entry = std::make_unique<sdbusplus::server::interface_t>(
+        logging->bus, path.c_str(), entryInterface, entryVtable, &entry);
+    entry.pelEntry = std::make_unique<sdbusplus::server::interface_t>(
+        logging->bus, path.c_str(), opEntryInterface, pelEntryVtable, &entry);
+
+    std::tuple<uint32_t, uint32_t> ids{logId, entry.pelId};
+    if (logging->latency.count() == 0)
+    {
+        auto reply = call.new_method_return();
+        reply.append(ids);
+        reply.method_return();
+        return 1;
+    }
+
+    auto clock = sdeventplus::Clock<sdeventplus::ClockId::Monotonic>(
+        logging->event);
+    logging->lastAnswer =
+        std::max(clock.now(), logging->lastAnswer) + logging->latency;
+    logging->answers.emplace(
+        std::piecewise_construct, std::forward_as_tuple(logId),
+        std::forward_as_tuple(
+            logging->event, logging->lastAnswer, std::chrono::milliseconds(1),
+            [logging, call, ids, logId](Timer&, Timer::TimePoint) mutable {
+                try
+                {
+                    auto reply = call.new_method_return();
+                    reply.append(ids);
+                    reply.method_return();
+                }
+                catch (const std::exception&)
+                {
+                    // The caller gave up on the call
+                }
+                // sd-event defers freeing the source until its dispatch
+                // returns
+                logging->answers.erase(logId);
+            }));
+    return 1;
+}
+
+int Logging::getEntryProperty(sd_bus*, const char*, const char*,
+                              const char* property, sd_bus_message* reply,
+                              void* context, sd_bus_error*)
+{
+    auto entry = static_cast<LogEntry*>(context);
+    sdbusplus::message_t msg{reply};
+    if (std::string_view{property} == "EventId")
+    {
+        msg.append(std::format("BD8D1002 {:08X}", entry->logId));
+    }
+    else
+    {
+        msg.append(entry->pelId);
+    }
+    return 1;
+}
+
+const sdbusplus::vtable::vtable_t DumpManager::createVtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::method("CreateDump", "a{sv}", "o", createDump),
+    sdbusplus::vtable::end()};
+
+const sdbusplus::vtable::vtable_t DumpManager::bmcCreateVtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::method("CreateDump", "a{sv}", "o", createBmcDump),
+    sdbusplus::vtable::end()};
+
+const sdbusplus::vtable::vtable_t DumpManager::progressVtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("Status", "s", getEntryProperty, setStatus,
+                                sdbusplus::vtable::property_::emits_change),
+    sdbusplus::vtable::property("StartTime", "t", getEntryProperty,
+                                sdbusplus::vtable::property_::emits_change),
+    sdbusplus::vtable::property("CompletedTime", "t", getEntryProperty,
+                                sdbusplus::vtable::property_::emits_change),
+    sdbusplus::vtable::end()};
+
+const sdbusplus::vtable::vtable_t DumpManager::typeVtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("ErrorLogId", "u", getEntryProperty,
+                                sdbusplus::vtable::property_::const_),
+    sdbusplus::vtable::end()};
+
+const sdbusplus::vtable::vtable_t DumpManager::failingUnitTypeVtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("ErrorLogId", "u", getEntryProperty,
+                                sdbusplus::vtable::property_::const_),
+    sdbusplus::vtable::property("FailingUnitId", "u", getEntryProperty,
+                                sdbusplus::vtable::property_::const_),
+    sdbusplus::vtable::end()};
+
+DumpManager::DumpManager(sdbusplus::bus_t& bus,
+                         const sdeventplus::Event& event,
+                         const std::filesystem::path& dumpDir) :
+    bus(bus), dumpDir(dumpDir),
+    systemDumps(bus, systemDumpPath, dumpCreateInterface, createVtable, this),
+    bmcDumps(bus, bmcDumpPath, dumpCreateInterface, bmcCreateVtable, this)
+{
+    std::filesystem::create_directories(dumpDir);
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd == -1)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to create the dump inotify");
+    }
+    inotifySource = std::make_unique<sdeventplus::source::IO>(
+        event, inotifyFd, EPOLLIN,
+        [this](sdeventplus::source::IO&, int, uint32_t) { dispatchInotify(); });
+}
+
+DumpManager::~DumpManager()
+{
+    inotifySource.reset();
+    close(inotifyFd);
+}
+
+int DumpManager::createDump(sd_bus_message* msg, void* context,
+                            sd_bus_error* error)
+{
+    auto manager = static_cast<DumpManager*>(context);
+    sdbusplus::message_t call{msg};
+    CreateParams params;
+    try
+    {
+        call.read(params);
+    }
+    catch (const std::exception&)
+    {
+        return sd_bus_error_set(error, SD_BUS_ERROR_INVALID_ARGS,
+                                "Invalid arguments");
+    }
+
+    // System dumps without a type would start a memory preserving reboot
+    auto typeIt = params.find(paramDumpType);
+    auto typeName = typeIt != params.end()
+                        ? std::get_if<std::string>(&typeIt->second)
+                        : nullptr;
+    auto dumpType = typeName ? dumpTypes.find(*typeName) : dumpTypes.end();
+    if (dumpType == dumpTypes.end())
+    {
+        return sd_bus_error_set(error, SD_BUS_ERROR_INVALID_ARGS,
+                                "Unsupported dump type");
+    }
+
+    // The monitor derives the dump type from the top digit of the id
+    auto id = (dumpType->second.idType << 28) | manager->nextId++;
+    auto idStr = std::format("{:08x}", id);
+    auto dir = manager->dumpDir / idStr;
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    auto watch = inotify_add_watch(manager->inotifyFd, dir.c_str(),
+                                   IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (ec || watch == -1)
+    {
+        return sd_bus_error_set(error, SD_BUS_ERROR_FAILED,
+                                "Failed to watch the dump directory");
+    }
+
+    auto path = std::format("{}/entry/{}", systemDumpPath, idStr);
+    auto& entry = manager->entries[path];
+    entry.manager = manager;
+    entry.path = path;
+    entry.status = statusInProgress;
+    entry.startTime = static_cast<uint64_t>(std::time(nullptr));
+    entry.errorLogId = uintParam(params, paramErrorLogId);
+    entry.failingUnitId = uintParam(params, paramFailingUnitId);
+    entry.watch = watch;
+    manager->watches[watch] = path;
+
+    entry.progress = std::make_unique<sdbusplus::server::interface_t>(
+        manager->bus, path.c_str(), progressInterface, progressVtable, &entry);
+    entry.type = std::make_unique<sdbusplus::server::interface_t>(
+        manager->bus, path.c_str(), dumpType->second.interface,
+        params.contains(paramFailingUnitId) ? failingUnitTypeVtable
+                                            : typeVtable,
+        &entry);
+    manager->bus.emit_object_added(path.c_str());
+
+    auto reply = call.new_method_return();
+    reply.append(sdbusplus::message::object_path(path));
+    reply.method_return();
+    return 1;
+}
+
+int DumpManager::createBmcDump(sd_bus_message* msg, void* context,
+                               sd_bus_error*)
+{
+    auto manager = static_cast<DumpManager*>(context);
+    sdbusplus::message_t call{msg};
+    auto reply = call.new_method_return();
+    reply.append(sdbusplus::message::object_path(
+        std::format("{}/entry/{}", bmcDumpPath, manager->nextBmcId++)));
+    reply.method_return();
+    return 1;
+}
+
+int DumpManager::getEntryProperty(sd_bus*, const char*, const char*,
+                                  const char* property, sd_bus_message* reply,
+                                  void* context, sd_bus_error*)
+{
+    auto entry = static_cast<Entry*>(context);
+    sdbusplus::message_t msg{reply};
+    std::string_view name{property};
+    if (name == "Status")
+    {
+        msg.append(entry->status);
+    }
+    else if (name == "StartTime")
+    {
+        msg.append(entry->startTime);
+    }
+    else if (name == "CompletedTime")
+    {
+        msg.append(entry->completedTime);
+    }
+    else if (name == "ErrorLogId")
+    {
+        msg.append(entry->errorLogId);
+    }
+    else
+    {
+        msg.append(entry->failingUnitId);
+    }
+    return 1;
+}
+
+int DumpManager::setStatus(sd_bus*, const char*, const char*, const char*,
+                           sd_bus_message* value, void* context,
+                           sd_bus_error* error)
+{
+    auto entry = static_cast<Entry*>(context);
+    std::string status;
+    try
+    {
+        sdbusplus::message_t msg{value};
+        msg.read(status);
+    }
+    catch (const std::exception&)
+    {
+        return sd_bus_error_set(error, SD_BUS_ERROR_INVALID_ARGS,
+                                "Invalid status");
+    }
+    entry->manager->updateStatus(*entry, status);
+    return 1;
+}
+
+void DumpManager::dispatchInotify()
+{
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length = 0;
+    while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0)
+    {
+        for (char* ptr = buffer; ptr < buffer + length;)
+        {
+            auto event = reinterpret_cast<const inotify_event*>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+
+            // The dump is written to a hidden file renamed once complete
+            auto watch = watches.find(event->wd);
+            if (watch == watches.end() || event->len == 0 ||
+                event->name[0] == '.')
+            {
+                continue;
+            }
+            auto entry = entries.find(watch->second);
+            if (entry != entries.end())
+            {
+                updateStatus(entry->second, statusCompleted);
+            }
+        }
+    }
+}
+
+void DumpManager::updateStatus(Entry& entry, const std::string& status)
+{
+    entry.status = status;
+    if (status != statusInProgress && entry.watch != -1)
+    {
+        entry.completedTime = static_cast<uint64_t>(std::time(nullptr));
+        inotify_rm_watch(inotifyFd, entry.watch);
+        watches.erase(entry.watch);
+        entry.watch = -1;
+    }
+    entry.progress->property_changed("Status");
+    entry.progress->property_changed("CompletedTime");
+}
+
+int runFakeServices(const FakeServiceConfig& config,
+                    const std::function<void()>& ready)
+{
+    auto event = sdeventplus::Event::get_default();
+    auto bus = sdbusplus::bus::new_default();
+    bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
+
+    // The entries are announced by InterfacesAdded from the dump root
+    sdbusplus::server::manager_t objectManager(bus, dumpRootPath);
+    ObjectMapper mapper(bus);
+    Logging logging(bus, event, config.pelLatency);
+    DumpManager dumps(bus, event, config.dumpDir);
+
+    bus.request_name(mapperBusName);
+    bus.request_name(loggingBusName);
+    bus.request_name(dumpManagerBusName);
+    ready();
+    return event.loop();
+}
+
+} // namespace openpower::dump::fake
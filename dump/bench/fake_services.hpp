@@ -0,0 +1,287 @@
+#pragma once
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+#include <sdeventplus/source/time.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace openpower::dump::fake
+{
+
+/* @brief Bus names of the services standing in for the BMC ones */
+constexpr auto dumpManagerBusName = "xyz.openbmc_project.Dump.Manager";
+constexpr auto loggingBusName = "xyz.openbmc_project.Logging";
+constexpr auto mapperBusName = "xyz.openbmc_project.ObjectMapper";
+
+/**
+ * @struct FakeServiceConfig
+ * @brief Behaviour of the fake services.
+ */
+struct FakeServiceConfig
+{
+    /** @brief Directory the dump entries expect their packaged dump in */
+    std::filesystem::path dumpDir;
+
+    /** @brief Time taken by the logging service to create each PEL */
+    std::chrono::milliseconds pelLatency{0};
+};
+
+/**
+ * @class ObjectMapper
+ * @brief Answers GetObject with the fake service hosting the path.
+ */
+class ObjectMapper
+{
+  public:
+    ObjectMapper() = delete;
+    ObjectMapper(const ObjectMapper&) = delete;
+    ObjectMapper& operator=(const ObjectMapper&) = delete;
+    ObjectMapper(ObjectMapper&&) = delete;
+    ObjectMapper& operator=(ObjectMapper&&) = delete;
+    ~ObjectMapper() = default;
+
+    explicit ObjectMapper(sdbusplus::bus_t& bus);
+
+  private:
+    /* @brief Methods exported on the mapper interface */
+    static const sdbusplus::vtable::vtable_t vtable[];
+
+    /* @brief Mapper object */
+    sdbusplus::server::interface_t mapper;
+
+    /**
+     * @brief sd-bus handler of the GetObject method.
+     */
+    static int getObject(sd_bus_message* msg, void* context,
+                         sd_bus_error* error);
+};
+
+/**
+ * @class Logging
+ * @brief Creates PELs through CreatePELWithFFDCFiles, after a latency.
+ *
+ * The calls are answered one after the other, each a latency after the
+ * previous answer, as the single threaded logging service does, without
+ * holding back the other services of the connection. Every PEL gets a log
+ * entry exporting its EventId and PlatformLogID.
+ */
+class Logging
+{
+  public:
+    Logging() = delete;
+    Logging(const Logging&) = delete;
+    Logging& operator=(const Logging&) = delete;
+    Logging(Logging&&) = delete;
+    Logging& operator=(Logging&&) = delete;
+    ~Logging() = default;
+
+    /**
+     * @brief Exports the logging object.
+     *
+     * @param[in] bus - Connection of the services
+     * @param[in] event - Event loop of the connection
+     * @param[in] latency - Time taken to create each PEL
+     */
+    Logging(sdbusplus::bus_t& bus, const sdeventplus::Event& event,
+            std::chrono::milliseconds latency);
+
+  private:
+    using Timer = sdeventplus::source::Time<sdeventplus::ClockId::Monotonic>;
+
+    /** @brief A log entry */
+    struct LogEntry
+    {
+        uint32_t logId = 0;
+        uint32_t pelId = 0;
+        std::unique_ptr<sdbusplus::server::interface_t> entry;
+        std::unique_ptr<sdbusplus::server::interface_t> pelEntry;
+    };
+
+    /* @brief Connection of the services */
+    sdbusplus::bus_t& bus;
+
+    /* @brief Event loop sending the delayed answers */
+    sdeventplus::Event event;
+
+    /* @brief Time taken to create each PEL */
+    const std::chrono::milliseconds latency;
+
+    /* @brief Methods and properties of the logging and entry objects */
+    static const sdbusplus::vtable::vtable_t vtable[];
+    static const sdbusplus::vtable::vtable_t entryVtable[];
+    static const sdbusplus::vtable::vtable_t pelEntryVtable[];
+
+    /* @brief Logging object */
+    sdbusplus::server::interface_t logging;
+
+    /* @brief Log entries keyed by id */
+    std::map<uint32_t, LogEntry> entries;
+
+    /* @brief Timers of the answers not sent yet, keyed by log id */
+    std::map<uint32_t, Timer> answers;
+
+    /* @brief Time the last answer is sent at */
+    Timer::TimePoint lastAnswer;
+
+    /**
+     * @brief sd-bus handler of the CreatePELWithFFDCFiles method.
+     */
+    static int createPEL(sd_bus_message* msg, void* context,
+                         sd_bus_error* error);
+
+    /**
+     * @brief sd-bus getter of the log entry properties.
+     */
+    static int getEntryProperty(sd_bus* bus, const char* path,
+                                const char* interface, const char* property,
+                                sd_bus_message* reply, void* context,
+                                sd_bus_error* error);
+};
+
+/**
+ * @class DumpManager
+ * @brief Creates system dump entries as the dump manager does.
+ *
+ * CreateDump on the system dump object adds an entry in progress, of the
+ * type given by its DumpType parameter, and emits InterfacesAdded. The
+ * entry completes once a file is written in its directory under the dump
+ * directory, as the dump manager sees the packaged dump arrive, and fails
+ * when its Status is set so. CreateDump on the BMC dump object is answered
+ * without creating an entry.
+ */
+class DumpManager
+{
+  public:
+    DumpManager() = delete;
+    DumpManager(const DumpManager&) = delete;
+    DumpManager& operator=(const DumpManager&) = delete;
+    DumpManager(DumpManager&&) = delete;
+    DumpManager& operator=(DumpManager&&) = delete;
+    ~DumpManager();
+
+    /**
+     * @brief Exports the dump objects.
+     *
+     * @param[in] bus - Connection of the services
+     * @param[in] event - Event loop of the connection
+     * @param[in] dumpDir - Directory receiving the packaged dumps
+     *
+     * Exceptions: std::system_error if the dump directory cannot be watched
+     */
+    DumpManager(sdbusplus::bus_t& bus, const sdeventplus::Event& event,
+                const std::filesystem::path& dumpDir);
+
+  private:
+    /** @brief A dump entry */
+    struct Entry
+    {
+        DumpManager* manager = nullptr;
+        std::string path;
+        std::string status;
+        uint64_t startTime = 0;
+        uint64_t completedTime = 0;
+        uint32_t errorLogId = 0;
+        uint32_t failingUnitId = 0;
+        int watch = -1;
+        std::unique_ptr<sdbusplus::server::interface_t> progress;
+        std::unique_ptr<sdbusplus::server::interface_t> type;
+    };
+
+    /* @brief Connection of the services */
+    sdbusplus::bus_t& bus;
+
+    /* @brief Directory receiving the packaged dumps */
+    const std::filesystem::path dumpDir;
+
+    /* @brief Methods and properties of the dump and entry objects */
+    static const sdbusplus::vtable::vtable_t createVtable[];
+    static const sdbusplus::vtable::vtable_t bmcCreateVtable[];
+    static const sdbusplus::vtable::vtable_t progressVtable[];
+    static const sdbusplus::vtable::vtable_t typeVtable[];
+    static const sdbusplus::vtable::vtable_t failingUnitTypeVtable[];
+
+    /* @brief System and BMC dump objects */
+    sdbusplus::server::interface_t systemDumps;
+    sdbusplus::server::interface_t bmcDumps;
+
+    /* @brief Watches the entry directories */
+    int inotifyFd = -1;
+
+    /* @brief Dispatches the inotify events */
+    std::unique_ptr<sdeventplus::source::IO> inotifySource;
+
+    /* @brief Entries keyed by path */
+    std::map<std::string, Entry> entries;
+
+    /* @brief Paths of the entries in progress, keyed by watch */
+    std::map<int, std::string> watches;
+
+    /* @brief Id of the next entry, without its type */
+    uint32_t nextId = 1;
+
+    /* @brief Id of the next BMC dump */
+    uint32_t nextBmcId = 1;
+
+    /**
+     * @brief sd-bus handler of CreateDump on the system dump object.
+     */
+    static int createDump(sd_bus_message* msg, void* context,
+                          sd_bus_error* error);
+
+    /**
+     * @brief sd-bus handler of CreateDump on the BMC dump object.
+     */
+    static int createBmcDump(sd_bus_message* msg, void* context,
+                             sd_bus_error* error);
+
+    /**
+     * @brief sd-bus getter of the entry properties.
+     */
+    static int getEntryProperty(sd_bus* bus, const char* path,
+                                const char* interface, const char* property,
+                                sd_bus_message* reply, void* context,
+                                sd_bus_error* error);
+
+    /**
+     * @brief sd-bus setter of the entry status.
+     */
+    static int setStatus(sd_bus* bus, const char* path, const char* interface,
+                         const char* property, sd_bus_message* value,
+                         void* context, sd_bus_error* error);
+
+    /**
+     * @brief Completes the entries whose dump was written.
+     */
+    void dispatchInotify();
+
+    /**
+     * @brief Records the status of an entry, its directory is no longer
+     * watched once the entry is done.
+     */
+    void updateStatus(Entry& entry, const std::string& status);
+};
+
+/**
+ * @brief Serves the fake services on the default bus until the event loop
+ * exits.
+ *
+ * @param[in] config - Behaviour of the services
+ * @param[in] ready - Called once the bus names are owned
+ *
+ * @return The exit code of the event loop
+ */
+int runFakeServices(const FakeServiceConfig& config,
+                    const std::function<void()>& ready);
+
+} // namespace openpower::dump::fake
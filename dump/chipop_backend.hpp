@@ -0,0 +1,224 @@
+#pragma once
+
+#include "dump_utils.hpp"
+#include "sbe_type.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+struct pdbg_target;
+
+namespace openpower::dump::sbe_chipop
+{
+
+/**
+ * @struct Chip
+ * @brief A chip which can service SBE chip-ops.
+ */
+struct Chip
+{
+    /** @brief SBE type of the chip */
+    SBETypes sbeType = SBETypes::PROC;
+
+    /** @brief Position of the chip, the pdbg target index */
+    uint32_t position = 0;
+
+    /** @brief pdbg target of the chip, nullptr for simulated chips */
+    struct pdbg_target* target = nullptr;
+
+    /** @brief FSI link used to reach an OCMB, unique within its proc */
+    uint32_t link = 0;
+
+    auto operator<=>(const Chip&) const = default;
+};
+
+/**
+ * @struct ProcTargets
+ * @brief The OCMB chips attached to a proc and how many of them are
+ * collected at the same time.
+ */
+struct ProcTargets
+{
+    /** @brief OCMB chips attached to the proc */
+    std::vector<Chip> ocmbs;
+
+    /** @brief Maximum OCMB chip-ops in flight on the proc */
+    size_t maxOcmbsPerProc = 1;
+
+    /** @brief Maximum OCMB chip-ops in flight on a single FSI link */
+    size_t maxOcmbsPerLink = 1;
+};
+
+/** @brief Proc chips mapped to the OCMB chips attached to them */
+using TargetMap = std::map<Chip, ProcTargets>;
+
+/** @brief Largest chunk of dump data handed over by a backend at once */
+constexpr size_t dumpChunkSize = 256 * 1024;
+
+/**
+ * @brief Receives the dump data of a chip-op in chunks of at most
+ * dumpChunkSize bytes, in order.
+ */
+using DumpChunkHandler = std::function<void(const uint8_t* data, size_t len)>;
+
+/**
+ * @struct SbeDumpTarget
+ * @brief Targets used by the SBE dump HWPs for a failing SBE.
+ */
+struct SbeDumpTarget
+{
+    /** @brief The chip containing the failing SBE */
+    Chip chip;
+
+    /** @brief The pib(proc) or fsi(odyssey) target used to reach the SBE */
+    struct pdbg_target* access = nullptr;
+};
+
+/**
+ * @class ChipOpBackend
+ * @brief Interface to the chip-ops used for dump collection.
+ *
+ * SbeDumpCollector issues every target discovery, chip-op and SBE dump HWP
+ * through this interface, so the collection pipeline can be driven either
+ * by the PHAL libraries or by a simulated system.
+ */
+class ChipOpBackend
+{
+  public:
+    ChipOpBackend() = default;
+    ChipOpBackend(const ChipOpBackend&) = delete;
+    ChipOpBackend& operator=(const ChipOpBackend&) = delete;
+    ChipOpBackend(ChipOpBackend&&) = delete;
+    ChipOpBackend& operator=(ChipOpBackend&&) = delete;
+    virtual ~ChipOpBackend() = default;
+
+    /**
+     * @brief Prepares the backend for target discovery and chip-ops.
+     */
+    virtual void initialize() = 0;
+
+    /**
+     * @brief Prepares the backend for the SBE dump HWPs.
+     */
+    virtual void initializeHwps() = 0;
+
+    /**
+     * @brief Returns the enabled and functional proc chips.
+     */
+    virtual std::vector<Chip> getFunctionalProcs() = 0;
+
+    /**
+     * @brief Returns the enabled and functional Odyssey OCMB chips
+     * attached to a proc.
+     *
+     * @param[in] proc - The proc chip
+     */
+    virtual std::vector<Chip> getFunctionalOcmbs(const Chip& proc) = 0;
+
+    /**
+     * @brief Stops the instructions on all threads of a proc.
+     *
+     * @param[in] proc - The proc chip
+     *
+     * Exceptions: openpower::phal::sbeError_t on chip-op failure
+     */
+    virtual void threadStop(const Chip& proc) = 0;
+
+    /**
+     * @brief Executes the get dump chip-op, streaming the response.
+     *
+     * The dump data is passed to the handler in chunks, which the collector
+     * writes out as they arrive. A backend reading the response from the SBE
+     * incrementally holds a chunk per chip at most, a backend receiving the
+     * whole response at once holds the whole dump until it is written. When
+     * the chip-op returns dump data along with FFDC not related to the
+     * chip-op, the data is streamed before the error is raised.
+     *
+     * @param[in] chip - The chip to collect the dump from
+     * @param[in] type - Type of the dump
+     * @param[in] clockState - Clock state to collect the dump with
+     * @param[in] collectFastArray - 1 if fastarray data is required
+     * @param[in] handler - Receives the dump data
+     *
+     * Exceptions: openpower::phal::sbeError_t on chip-op failure
+     */
+    virtual void getDump(const Chip& chip, uint8_t type, uint8_t clockState,
+                         uint8_t collectFastArray,
+                         const DumpChunkHandler& handler) = 0;
+
+    /**
+     * @brief Prepares the targets for the SBE dump HWPs.
+     *
+     * @param[in] failingUnit - Position of the chip containing failing SBE
+     * @param[in] sbeTypeId - SBE dump type of the failing SBE
+     *
+     * @return Targets to be passed to the SBE dump HWPs
+     */
+    virtual SbeDumpTarget prepareSbeDump(uint32_t failingUnit,
+                                         int sbeTypeId) = 0;
+
+    /**
+     * @brief Checks whether the SBE is in a state to collect the dump.
+     */
+    virtual void checkSbeState(const SbeDumpTarget& target,
+                               int sbeTypeId) = 0;
+
+    /**
+     * @brief Executes the SBE extract rc HWP.
+     */
+    virtual void executeSbeExtractRc(const SbeDumpTarget& target,
+                                     const std::filesystem::path& dumpPath,
+                                     int sbeTypeId) = 0;
+
+    /**
+     * @brief Collects the SBE local register dump.
+     */
+    virtual void collectLocalRegDump(const SbeDumpTarget& target,
+                                     const std::filesystem::path& dumpPath,
+                                     const std::string& baseFilename,
+                                     int sbeTypeId) = 0;
+
+    /**
+     * @brief Collects the SBE PIBMS register dump.
+     */
+    virtual void collectPIBMSRegDump(const SbeDumpTarget& target,
+                                     const std::filesystem::path& dumpPath,
+                                     const std::string& baseFilename,
+                                     int sbeTypeId) = 0;
+
+    /**
+     * @brief Collects the SBE PIBMEM dump.
+     */
+    virtual void collectPIBMEMDump(const SbeDumpTarget& target,
+                                   const std::filesystem::path& dumpPath,
+                                   const std::string& baseFilename,
+                                   int sbeTypeId) = 0;
+
+    /**
+     * @brief Collects the SBE PPE state.
+     */
+    virtual void collectPPEState(const SbeDumpTarget& target,
+                                 const std::filesystem::path& dumpPath,
+                                 const std::string& baseFilename,
+                                 int sbeTypeId) = 0;
+
+    /**
+     * @brief Finalizes the SBE dump collection.
+     *
+     * @param[in] target - Targets of the failing SBE
+     * @param[in] dumpPath - Path to the dump files
+     * @param[in] success - Whether the collection was successful
+     * @param[in] sbeTypeId - SBE dump type of the failing SBE
+     */
+    virtual void finalizeSbeDump(const SbeDumpTarget& target,
+                                 const std::filesystem::path& dumpPath,
+                                 bool success, int sbeTypeId) = 0;
+};
+
+} // namespace openpower::dump::sbe_chipop
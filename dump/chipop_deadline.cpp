@@ -0,0 +1,317 @@
+#include "chipop_deadline.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace openpower::dump::sbe_chipop
+{
+
+struct ChipOpCaller::State
+{
+    /** @brief Protects the members below, held by the caller callbacks */
+    std::mutex mutex;
+
+    /** @brief Signalled when the chip-op completes */
+    std::condition_variable completion;
+
+    /** @brief Set when a helper starts the chip-op */
+    bool started = false;
+
+    /** @brief Set when the chip-op completes */
+    bool done = false;
+
+    /** @brief Set when the caller stops waiting */
+    bool abandoned = false;
+
+    /** @brief Exception raised by the chip-op */
+    std::exception_ptr error;
+};
+
+struct ChipOpRunner::Helpers
+{
+    explicit Helpers(size_t maxThreads) : maxThreads(maxThreads) {}
+
+    /** @brief A helper thread */
+    struct Helper
+    {
+        std::thread thread;
+
+        /** @brief Set while the helper runs a chip-op */
+        bool running = false;
+    };
+
+    /** @brief A queued chip-op */
+    struct Task
+    {
+        /** @brief Completion of the chip-op */
+        std::shared_ptr<ChipOpCaller::State> state;
+
+        /** @brief Runs the chip-op unless its caller stopped waiting */
+        std::function<void()> run;
+    };
+
+    /** @brief Protects the members below */
+    std::mutex mutex;
+
+    /** @brief Signalled when a chip-op is queued or the runner stops */
+    std::condition_variable workAvailable;
+
+    /** @brief Chip-ops waiting for a helper */
+    std::deque<Task> tasks;
+
+    /** @brief Most helper threads */
+    size_t maxThreads;
+
+    /** @brief Helper threads started, they exit when the runner stops */
+    std::vector<std::unique_ptr<Helper>> threads;
+
+    /** @brief Helper threads waiting for a chip-op */
+    size_t idle = 0;
+
+    /** @brief Set when the helpers have to exit once idle */
+    bool stopping = false;
+
+    /** @brief Chips running an abandoned chip-op, by SBE type and position */
+    std::set<std::pair<SBETypes, uint32_t>> busyChips;
+
+    /**
+     * @brief Main loop of a helper thread.
+     */
+    static void run(const std::shared_ptr<Helpers>& helpers, Helper& self);
+};
+
+namespace
+{
+
+int64_t elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+} // namespace
+
+void ChipOpRunner::Helpers::run(const std::shared_ptr<Helpers>& helpers,
+                                Helper& self)
+{
+    std::unique_lock lock(helpers->mutex);
+    while (true)
+    {
+        helpers->idle++;
+        helpers->workAvailable.wait(lock, [&helpers]() {
+            return helpers->stopping || !helpers->tasks.empty();
+        });
+        helpers->idle--;
+        if (helpers->tasks.empty())
+        {
+            break;
+        }
+        auto task = std::move(helpers->tasks.front());
+        helpers->tasks.pop_front();
+        self.running = true;
+        lock.unlock();
+        task.run();
+        lock.lock();
+        self.running = false;
+    }
+}
+
+bool ChipOpCaller::call(const std::function<void()>& func) const
+{
+    if (!state)
+    {
+        func();
+        return true;
+    }
+
+    std::lock_guard lock(state->mutex);
+    if (state->abandoned)
+    {
+        return false;
+    }
+    func();
+    return true;
+}
+
+ChipOpRunner::ChipOpRunner(size_t maxHelpers) :
+    helpers(std::make_shared<Helpers>(std::max<size_t>(maxHelpers, 1)))
+{}
+
+ChipOpRunner::~ChipOpRunner()
+{
+    // No caller is left, so a helper running a chip-op runs an abandoned
+    // one. It is left to exit once the chip-op returns, the idle helpers
+    // are joined.
+    std::vector<std::thread> idle;
+    {
+        std::lock_guard lock(helpers->mutex);
+        helpers->stopping = true;
+        helpers->workAvailable.notify_all();
+        for (auto& helper : helpers->threads)
+        {
+            if (helper->running)
+            {
+                helper->thread.detach();
+            }
+            else
+            {
+                idle.push_back(std::move(helper->thread));
+            }
+        }
+    }
+    for (auto& thread : idle)
+    {
+        thread.join();
+    }
+}
+
+void ChipOpRunner::setMaxHelpers(size_t maxHelpers)
+{
+    std::lock_guard lock(helpers->mutex);
+    helpers->maxThreads = std::max<size_t>(maxHelpers, 1);
+}
+
+ChipOpRun ChipOpRunner::run(const Chip& chip, const std::string& name,
+                            const ChipOpLimit& limit, ChipOp chipOp)
+{
+    if (!limit)
+    {
+        chipOp(ChipOpCaller{});
+        return ChipOpRun::completed;
+    }
+
+    auto state = std::make_shared<ChipOpCaller::State>();
+    auto start = std::chrono::steady_clock::now();
+    auto key = std::make_pair(chip.sbeType, chip.position);
+    auto task = [helpers = helpers, state, key, name, start,
+                 chipOp = std::move(chipOp)]() {
+        {
+            // The caller stopped waiting before a helper was free
+            std::lock_guard lock(state->mutex);
+            if (state->abandoned)
+            {
+                return;
+            }
+            state->started = true;
+        }
+
+        std::exception_ptr error;
+        try
+        {
+            chipOp(ChipOpCaller{state});
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        bool late = false;
+        {
+            std::lock_guard lock(state->mutex);
+            state->done = true;
+            state->error = error;
+            late = state->abandoned;
+            state->completion.notify_one();
+        }
+        if (!late)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard lock(helpers->mutex);
+            helpers->busyChips.erase(key);
+        }
+        try
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+            lg2::error("Abandoned chip-op {CHIPOP} completed after "
+                       "{ELAPSED}ms, its data is dropped",
+                       "CHIPOP", name, "ELAPSED", elapsedMs(start));
+        }
+        catch (const std::exception& e)
+        {
+            lg2::error("Abandoned chip-op {CHIPOP} failed after {ELAPSED}ms, "
+                       "its FFDC is dropped: {ERROR}",
+                       "CHIPOP", name, "ELAPSED", elapsedMs(start), "ERROR",
+                       e);
+        }
+    };
+
+    bool queued = false;
+    {
+        std::lock_guard lock(helpers->mutex);
+        if (helpers->idle == 0 &&
+            helpers->threads.size() < helpers->maxThreads)
+        {
+            auto& helper = *helpers->threads.emplace_back(
+                std::make_unique<Helpers::Helper>());
+            try
+            {
+                helper.thread = std::thread(Helpers::run, helpers,
+                                            std::ref(helper));
+            }
+            catch (const std::system_error& e)
+            {
+                helpers->threads.pop_back();
+                lg2::error("Failed to start a chip-op helper, {ERROR}",
+                           "ERROR", e);
+            }
+        }
+        if (!helpers->threads.empty())
+        {
+            helpers->tasks.push_back({state, task});
+            helpers->workAvailable.notify_one();
+            queued = true;
+        }
+    }
+    if (!queued)
+    {
+        // Without any helper the chip-op can only be waited for
+        lg2::error("Running chip-op {CHIPOP} without its limit", "CHIPOP",
+                   name);
+        task();
+    }
+
+    std::unique_lock lock(state->mutex);
+    if (!state->completion.wait_until(lock, *limit,
+                                      [&state]() { return state->done; }))
+    {
+        state->abandoned = true;
+        if (!state->started)
+        {
+            return ChipOpRun::notStarted;
+        }
+        std::lock_guard helpersLock(helpers->mutex);
+        helpers->busyChips.insert(key);
+        return ChipOpRun::abandoned;
+    }
+    if (state->error)
+    {
+        std::rethrow_exception(state->error);
+    }
+    return ChipOpRun::completed;
+}
+
+bool ChipOpRunner::isBusy(const Chip& chip) const
+{
+    std::lock_guard lock(helpers->mutex);
+    return helpers->busyChips.contains({chip.sbeType, chip.position});
+}
+
+} // namespace openpower::dump::sbe_chipop
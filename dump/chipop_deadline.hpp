@@ -0,0 +1,151 @@
+#pragma once
+
+#include "chipop_backend.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace openpower::dump::sbe_chipop
+{
+
+/**
+ * @brief Time a caller stops waiting for a chip-op, none to wait until the
+ * chip-op completes.
+ */
+using ChipOpLimit = std::optional<std::chrono::steady_clock::time_point>;
+
+/**
+ * @brief Outcome of a chip-op run by ChipOpRunner.
+ */
+enum class ChipOpRun
+{
+    /** @brief The chip-op completed */
+    completed,
+
+    /** @brief The chip-op overran its limit and was not waited for */
+    abandoned,
+
+    /** @brief No helper was free before the limit, the chip-op was not run */
+    notStarted
+};
+
+/**
+ * @class ChipOpCaller
+ * @brief Link from a chip-op run by ChipOpRunner back to its caller.
+ */
+class ChipOpCaller
+{
+  public:
+    /**
+     * @brief Runs a function in the state of the caller, e.g. to write the
+     * dump data, unless the caller stopped waiting for the chip-op.
+     *
+     * The caller does not stop waiting while the function runs.
+     *
+     * @param[in] func - The function
+     *
+     * @return false if the chip-op was abandoned, the function is not run
+     */
+    bool call(const std::function<void()>& func) const;
+
+  private:
+    /** @brief Completion of a chip-op, shared with its helper thread */
+    struct State;
+
+    /** @brief Completion of the chip-op, nullptr if run by the caller */
+    std::shared_ptr<State> state;
+
+    ChipOpCaller() = default;
+    explicit ChipOpCaller(std::shared_ptr<State> state) :
+        state(std::move(state))
+    {}
+
+    friend class ChipOpRunner;
+};
+
+/**
+ * @class ChipOpRunner
+ * @brief Runs chip-ops the caller may stop waiting for.
+ *
+ * A chip-op cannot be cancelled, it lasts until the SBE answers or libphal
+ * gives up after its own timeout. A chip-op with a limit runs on one of a
+ * bounded set of helper threads, and the caller stops waiting for it at the
+ * limit. The abandoned chip-op keeps its chip busy until it completes, the
+ * chip-ops of the later collections skip the busy chips, and its late
+ * outcome is logged. A chip-op still queued at the limit is not started.
+ *
+ * The runner joins its helpers when destroyed, except the ones still in an
+ * abandoned chip-op, which are left to exit once the chip-op returns.
+ */
+class ChipOpRunner
+{
+  public:
+    using ChipOp = std::function<void(const ChipOpCaller&)>;
+
+    ChipOpRunner() = delete;
+    ChipOpRunner(const ChipOpRunner&) = delete;
+    ChipOpRunner& operator=(const ChipOpRunner&) = delete;
+    ChipOpRunner(ChipOpRunner&&) = delete;
+    ChipOpRunner& operator=(ChipOpRunner&&) = delete;
+
+    /**
+     * @brief Creates the runner, the helper threads are started on demand.
+     *
+     * @param[in] maxHelpers - Most helper threads running chip-ops at once
+     */
+    explicit ChipOpRunner(size_t maxHelpers);
+
+    /**
+     * @brief Stops the helper threads and joins the ones not running an
+     * abandoned chip-op.
+     */
+    ~ChipOpRunner();
+
+    /**
+     * @brief Sets the most helper threads running chip-ops at once. The
+     * helpers already started are kept.
+     *
+     * @param[in] maxHelpers - Most helper threads, at least one
+     */
+    void setMaxHelpers(size_t maxHelpers);
+
+    /**
+     * @brief Runs a chip-op, waiting for it until a time limit.
+     *
+     * Without a limit the chip-op runs on the calling thread. With a limit
+     * the chip-op may outlive the call, so it must only capture what
+     * outlives the caller and reach the state of the caller through the
+     * ChipOpCaller it is given.
+     *
+     * @param[in] chip - Chip of the chip-op
+     * @param[in] name - Name of the chip-op in the logs
+     * @param[in] limit - Time the caller stops waiting
+     * @param[in] chipOp - The chip-op
+     *
+     * @return Whether the chip-op completed, was abandoned or never started
+     *
+     * Exceptions: the exception raised by the chip-op, if it completed
+     */
+    ChipOpRun run(const Chip& chip, const std::string& name,
+                  const ChipOpLimit& limit, ChipOp chipOp);
+
+    /**
+     * @brief Whether a chip is still running an abandoned chip-op.
+     *
+     * @param[in] chip - The chip
+     */
+    bool isBusy(const Chip& chip) const;
+
+  private:
+    /** @brief Helper threads and busy chips, shared with the helpers */
+    struct Helpers;
+
+    std::shared_ptr<Helpers> helpers;
+};
+
+} // namespace openpower::dump::sbe_chipop
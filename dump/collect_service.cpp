@@ -0,0 +1,173 @@
+#include "collect_service.hpp"
+
+#include "sbe_consts.hpp"
+
+#include <systemd/sd-bus.h>
+
+#include <phosphor-logging/lg2.hpp>
+#include <xyz/openbmc_project/Common/error.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace openpower::dump
+{
+
+using InternalFailure =
+    sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure;
+
+const sdbusplus::vtable::vtable_t CollectService::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::method("Collect", "yuusu", "", collect),
+    sdbusplus::vtable::property("CollectionTime", "t", getTimingProperty,
+                                sdbusplus::vtable::property_::emits_change),
+    sdbusplus::vtable::property(
+        "PhaseLatencies", "a(sttttt)", getTimingProperty,
+        sdbusplus::vtable::property_::emits_invalidation),
+    sdbusplus::vtable::property(
+        "ChipLatencies", "a(suttt)", getTimingProperty,
+        sdbusplus::vtable::property_::emits_invalidation),
+    sdbusplus::vtable::end()};
+
+int CollectService::getTimingProperty(sd_bus*, const char*, const char*,
+                                      const char* property,
+                                      sd_bus_message* reply, void* context,
+                                      sd_bus_error*)
+{
+    auto service = static_cast<CollectService*>(context);
+    std::string name{property};
+    try
+    {
+        sdbusplus::message_t msg{reply};
+        auto timing = service->engine.getCollector().lastTiming();
+        if (name == "CollectionTime")
+        {
+            msg.append(timing.totalUs);
+        }
+        else if (name == "PhaseLatencies")
+        {
+            std::vector<std::tuple<std::string, uint64_t, uint64_t, uint64_t,
+                                   uint64_t, uint64_t>>
+                phases;
+            for (size_t i = 0; i < timingPhaseCount; i++)
+            {
+                const auto& histogram = timing.phases[i];
+                phases.emplace_back(
+                    timingPhaseName(static_cast<TimingPhase>(i)),
+                    histogram.count, histogram.totalUs,
+                    histogram.percentile(50), histogram.percentile(99),
+                    histogram.maxUs);
+            }
+            msg.append(phases);
+        }
+        else
+        {
+            std::vector<
+                std::tuple<std::string, uint32_t, uint64_t, uint64_t, uint64_t>>
+                chips;
+            for (const auto& [key, chip] : timing.chips)
+            {
+                chips.emplace_back(sbeTypeAttributes.at(key.first).chipName,
+                                   key.second, chip.chipOps, chip.totalUs,
+                                   chip.maxUs);
+            }
+            std::ranges::stable_sort(chips, std::ranges::greater{},
+                                     [](const auto& chip) {
+                                         return std::get<3>(chip);
+                                     });
+            msg.append(chips);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to get property {PROPERTY} {ERROR}", "PROPERTY",
+                   name, "ERROR", e);
+        return -EINVAL;
+    }
+    return 1;
+}
+
+int CollectService::collect(sd_bus_message* msg, void* context,
+                            sd_bus_error* error)
+{
+    using namespace openpower::dump::SBE;
+
+    auto service = static_cast<CollectService*>(context);
+    sdbusplus::message_t call{msg};
+
+    uint8_t type = 0;
+    uint32_t id = 0;
+    uint32_t failingUnit = 0;
+    std::string pathStr;
+    uint32_t deadline = 0;
+    try
+    {
+        call.read(type, id, failingUnit, pathStr, deadline);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to read the Collect arguments {ERROR}", "ERROR", e);
+        return sd_bus_error_set(error, SD_BUS_ERROR_INVALID_ARGS,
+                                "Invalid arguments");
+    }
+
+    if ((type != SBE_DUMP_TYPE_HARDWARE) && (type != SBE_DUMP_TYPE_HOSTBOOT) &&
+        (type != SBE_DUMP_TYPE_SBE) && (type != SBE_DUMP_TYPE_PERFORMANCE) &&
+        (type != SBE_DUMP_TYPE_MSBE))
+    {
+        return sd_bus_error_set(error, SD_BUS_ERROR_INVALID_ARGS,
+                                "Invalid dump type");
+    }
+
+    std::filesystem::path path{pathStr};
+    std::error_code ec;
+    if (!path.is_absolute() ||
+        (!std::filesystem::create_directories(path, ec) && ec))
+    {
+        return sd_bus_error_set(error, SD_BUS_ERROR_INVALID_ARGS,
+                                "Invalid dump path");
+    }
+
+    lg2::info("Collect request: type({TYPE}) id({ID}) "
+              "failingUnit({FAILINGUNIT}) path({PATH}) deadline({DEADLINE}s)",
+              "TYPE", type, "ID", id, "FAILINGUNIT", failingUnit, "PATH",
+              pathStr, "DEADLINE", deadline);
+
+    // The call is referenced until the reply is sent from the event loop
+    auto reply = [service, call, id](bool success) mutable {
+        // The latencies of a failed collection are published as well
+        service->collector.property_changed("CollectionTime");
+        service->collector.property_changed("PhaseLatencies");
+        service->collector.property_changed("ChipLatencies");
+        try
+        {
+            if (success)
+            {
+                call.new_method_return().method_return();
+            }
+            else
+            {
+                call.new_method_error(InternalFailure()).method_return();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            lg2::error("Failed to reply to the collection of dump {ID}, "
+                       "{ERROR}",
+                       "ID", id, "ERROR", e);
+        }
+    };
+    service->engine.collect(type, id, failingUnit, path,
+                            std::chrono::seconds(deadline), std::move(reply));
+    return 1;
+}
+
+} // namespace openpower::dump
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "dump_engine.hpp"
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+
+namespace openpower::dump
+{
+
+/* @brief Bus name, object and interface of the dump-collect daemon */
+constexpr auto collectorBusName = "org.open_power.Dump.Collector";
+constexpr auto collectorObjectPath = "/org/open_power/dump/collector";
+constexpr auto collectorInterface = "org.open_power.Dump.Collector";
+
+/**
+ * @class CollectService
+ * @brief Exports the Collect method of the dump-collect daemon.
+ *
+ * Collect(type, id, failingUnit, path, deadline) collects the dump files in
+ * path, as dump-collect does, through an engine whose collector was
+ * initialized when the daemon started. The deadline is the time allowed for
+ * a hardware or hostboot collection in seconds, 0 for no limit. The reply
+ * is sent once the collection is done, the event loop keeps serving other
+ * calls meanwhile.
+ *
+ * The latencies of the last hardware or hostboot dump are exported as
+ * properties, with the slowest chips first:
+ *  - CollectionTime (t): duration of the collection in us
+ *  - PhaseLatencies (a(sttttt)): phase, count, total, p50, p99 and max us
+ *  - ChipLatencies (a(suttt)): chip, position, chip-ops, total and max us
+ */
+class CollectService
+{
+  public:
+    CollectService() = delete;
+    CollectService(const CollectService&) = delete;
+    CollectService& operator=(const CollectService&) = delete;
+    CollectService(CollectService&&) = delete;
+    CollectService& operator=(CollectService&&) = delete;
+    ~CollectService() = default;
+
+    /**
+     * @brief Exports the collector object and requests the bus name.
+     *
+     * @param[in] bus - Connection of the event loop thread
+     * @param[in] engine - Engine running the collections
+     */
+    CollectService(sdbusplus::bus_t& bus, DumpEngine& engine) :
+        engine(engine),
+        collector(bus, collectorObjectPath, collectorInterface, vtable, this)
+    {
+        bus.request_name(collectorBusName);
+    }
+
+  private:
+    /* @brief Engine running the collections */
+    DumpEngine& engine;
+
+    /* @brief Methods and properties exported on collectorInterface */
+    static const sdbusplus::vtable::vtable_t vtable[];
+
+    /* @brief Collector object */
+    sdbusplus::server::interface_t collector;
+
+    /**
+     * @brief sd-bus handler of the Collect method, replies once the
+     * collection is done.
+     */
+    static int collect(sd_bus_message* msg, void* context,
+                       sd_bus_error* error);
+
+    /**
+     * @brief sd-bus getter of the latency properties.
+     */
+    static int getTimingProperty(sd_bus* bus, const char* path,
+                                 const char* interface, const char* property,
+                                 sd_bus_message* reply, void* context,
+                                 sd_bus_error* error);
+};
+
+} // namespace openpower::dump
@@ -0,0 +1,174 @@
+#include "collection_timing.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace openpower::dump
+{
+
+namespace
+{
+
+uint64_t toUs(CollectionTiming::Clock::duration elapsed)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+    return static_cast<uint64_t>(std::max<int64_t>(us.count(), 0));
+}
+
+} // namespace
+
+std::string_view timingPhaseName(TimingPhase phase)
+{
+    switch (phase)
+    {
+        case TimingPhase::discovery:
+            return "discovery";
+        case TimingPhase::threadStop:
+            return "threadStop";
+        case TimingPhase::getDump:
+            return "getDump";
+        case TimingPhase::fileWrite:
+            return "fileWrite";
+        case TimingPhase::pelCreation:
+            return "pelCreation";
+        case TimingPhase::nestedDumpWait:
+            return "nestedDumpWait";
+    }
+    return "unknown";
+}
+
+void LatencyHistogram::record(uint64_t us)
+{
+    auto bucket = std::min<size_t>(std::bit_width(us), bucketCount - 1);
+    buckets[bucket]++;
+    count++;
+    totalUs += us;
+    maxUs = std::max(maxUs, us);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (size_t i = 0; i < bucketCount; i++)
+    {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    totalUs += other.totalUs;
+    maxUs = std::max(maxUs, other.maxUs);
+}
+
+uint64_t LatencyHistogram::percentile(double percent) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    auto rank = static_cast<uint64_t>(std::ceil(count * percent / 100.0));
+    rank = std::clamp<uint64_t>(rank, 1, count);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucketCount; i++)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+        {
+            // The bucket bound, never more than the longest latency seen
+            return std::min(i == 0 ? 0 : (uint64_t{1} << i) - 1, maxUs);
+        }
+    }
+    return maxUs;
+}
+
+nlohmann::json TimingSummary::toJson() const
+{
+    auto phasesJson = nlohmann::json::object();
+    for (size_t i = 0; i < timingPhaseCount; i++)
+    {
+        const auto& histogram = phases[i];
+        if (histogram.count == 0)
+        {
+            continue;
+        }
+
+        // Trailing empty buckets are left out
+        std::vector<uint64_t> buckets(histogram.buckets.begin(),
+                                      histogram.buckets.end());
+        while (buckets.back() == 0)
+        {
+            buckets.pop_back();
+        }
+
+        phasesJson[timingPhaseName(static_cast<TimingPhase>(i))] = {
+            {"count", histogram.count},
+            {"totalUs", histogram.totalUs},
+            {"maxUs", histogram.maxUs},
+            {"p50Us", histogram.percentile(50)},
+            {"p99Us", histogram.percentile(99)},
+            {"log2Buckets", buckets}};
+    }
+
+    // Slowest chips first
+    std::vector<std::pair<std::pair<SBETypes, uint32_t>, ChipTiming>> sorted(
+        chips.begin(), chips.end());
+    std::ranges::stable_sort(sorted, std::ranges::greater{},
+                             [](const auto& chip) {
+                                 return chip.second.totalUs;
+                             });
+    auto chipsJson = nlohmann::json::array();
+    for (const auto& [key, chip] : sorted)
+    {
+        chipsJson.push_back({{"chip", sbeTypeAttributes.at(key.first).chipName},
+                             {"position", key.second},
+                             {"chipOps", chip.chipOps},
+                             {"totalUs", chip.totalUs},
+                             {"maxUs", chip.maxUs}});
+    }
+
+    return {{"version", 1},
+            {"totalUs", totalUs},
+            {"phases", phasesJson},
+            {"chips", chipsJson}};
+}
+
+void CollectionTiming::record(TimingPhase phase, Clock::duration elapsed)
+{
+    threads.local().phases[static_cast<size_t>(phase)].record(toUs(elapsed));
+}
+
+void CollectionTiming::recordChipOp(SBETypes sbeType, uint32_t position,
+                                    Clock::duration elapsed)
+{
+    auto us = toUs(elapsed);
+    auto& local = threads.local();
+    local.phases[static_cast<size_t>(TimingPhase::getDump)].record(us);
+
+    auto& chip = local.chips[{sbeType, position}];
+    chip.chipOps++;
+    chip.totalUs += us;
+    chip.maxUs = std::max(chip.maxUs, us);
+}
+
+TimingSummary CollectionTiming::summarize() const
+{
+    TimingSummary summary;
+    threads.forEach([&summary](size_t, const ThreadTiming& thread) {
+        for (size_t i = 0; i < timingPhaseCount; i++)
+        {
+            summary.phases[i].merge(thread.phases[i]);
+        }
+        for (const auto& [key, chip] : thread.chips)
+        {
+            auto& total = summary.chips[key];
+            total.chipOps += chip.chipOps;
+            total.totalUs += chip.totalUs;
+            total.maxUs = std::max(total.maxUs, chip.maxUs);
+        }
+    });
+    summary.totalUs = toUs(Clock::now() - start);
+    return summary;
+}
+
+} // namespace openpower::dump
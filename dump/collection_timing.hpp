@@ -0,0 +1,183 @@
+#pragma once
+
+#include "per_thread.hpp"
+#include "sbe_type.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <utility>
+
+namespace openpower::dump
+{
+
+/**
+ * @brief Steps of a dump collection whose latency is measured.
+ */
+enum class TimingPhase : uint8_t
+{
+    discovery,
+    threadStop,
+    getDump,
+    fileWrite,
+    pelCreation,
+    nestedDumpWait,
+};
+
+/** @brief Number of TimingPhase values */
+constexpr size_t timingPhaseCount = 6;
+
+/**
+ * @brief Returns the name of a phase as it appears in the summaries.
+ */
+std::string_view timingPhaseName(TimingPhase phase);
+
+/**
+ * @struct LatencyHistogram
+ * @brief Latencies in microseconds, in power of two buckets.
+ *
+ * Bucket i counts the latencies below 2^i us which are not in a lower
+ * bucket, the last bucket also counts anything longer.
+ */
+struct LatencyHistogram
+{
+    static constexpr size_t bucketCount = 40;
+
+    std::array<uint64_t, bucketCount> buckets{};
+    uint64_t count = 0;
+    uint64_t totalUs = 0;
+    uint64_t maxUs = 0;
+
+    /**
+     * @brief Adds a latency.
+     */
+    void record(uint64_t us);
+
+    /**
+     * @brief Adds the latencies of another histogram.
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * @brief Returns an upper bound of a percentile, in us.
+     *
+     * @param[in] percent - The percentile, 0 to 100
+     */
+    uint64_t percentile(double percent) const;
+};
+
+/**
+ * @struct ChipTiming
+ * @brief Time spent in the getDump chip-ops of a chip.
+ */
+struct ChipTiming
+{
+    uint64_t chipOps = 0;
+    uint64_t totalUs = 0;
+    uint64_t maxUs = 0;
+};
+
+/**
+ * @struct TimingSummary
+ * @brief Latencies of a dump collection.
+ */
+struct TimingSummary
+{
+    /** @brief Latencies of each phase, indexed by TimingPhase */
+    std::array<LatencyHistogram, timingPhaseCount> phases;
+
+    /** @brief getDump time of each chip, keyed by SBE type and position */
+    std::map<std::pair<SBETypes, uint32_t>, ChipTiming> chips;
+
+    /** @brief Duration of the whole collection */
+    uint64_t totalUs = 0;
+
+    /**
+     * @brief Returns the summary as written in timing.json.
+     */
+    nlohmann::json toJson() const;
+};
+
+/**
+ * @class CollectionTiming
+ * @brief Collects the latencies measured during a dump collection.
+ *
+ * Every thread records into histograms of its own, so recording takes no
+ * lock after the first record of the thread. summarize() merges the
+ * histograms and must only be called once the recording threads are done.
+ */
+class CollectionTiming
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    CollectionTiming() = default;
+    CollectionTiming(const CollectionTiming&) = delete;
+    CollectionTiming& operator=(const CollectionTiming&) = delete;
+    CollectionTiming(CollectionTiming&&) = delete;
+    CollectionTiming& operator=(CollectionTiming&&) = delete;
+    ~CollectionTiming() = default;
+
+    /**
+     * @brief Records the latency of a phase.
+     */
+    void record(TimingPhase phase, Clock::duration elapsed);
+
+    /**
+     * @brief Records the latency of a getDump chip-op on a chip.
+     */
+    void recordChipOp(SBETypes sbeType, uint32_t position,
+                      Clock::duration elapsed);
+
+    /**
+     * @brief Merges the latencies recorded by all the threads.
+     */
+    TimingSummary summarize() const;
+
+  private:
+    /** @brief Histograms of a thread */
+    struct ThreadTiming
+    {
+        std::array<LatencyHistogram, timingPhaseCount> phases;
+        std::map<std::pair<SBETypes, uint32_t>, ChipTiming> chips;
+    };
+
+    /** @brief Start of the collection */
+    const Clock::time_point start = Clock::now();
+
+    /** @brief Histograms of the recording threads */
+    PerThread<ThreadTiming> threads;
+};
+
+/**
+ * @class PhaseTimer
+ * @brief Records the time spent in a scope as a phase latency.
+ */
+class PhaseTimer
+{
+  public:
+    PhaseTimer(CollectionTiming& timing, TimingPhase phase) :
+        timing(timing), phase(phase)
+    {}
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+    PhaseTimer(PhaseTimer&&) = delete;
+    PhaseTimer& operator=(PhaseTimer&&) = delete;
+
+    ~PhaseTimer()
+    {
+        timing.record(phase, CollectionTiming::Clock::now() - start);
+    }
+
+  private:
+    CollectionTiming& timing;
+    const TimingPhase phase;
+    const CollectionTiming::Clock::time_point start =
+        CollectionTiming::Clock::now();
+};
+
+} // namespace openpower::dump
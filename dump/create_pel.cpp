@@ -3,7 +3,6 @@
 #include "dump_utils.hpp"
 #include "sbe_consts.hpp"
 
-#include <fcntl.h>
 #include <libekb.H>
 #include <unistd.h>
 
@@ -12,15 +11,17 @@
 #include <xyz/openbmc_project/Logging/Create/server.hpp>
 #include <xyz/openbmc_project/Logging/Entry/server.hpp>
 
-#include <cerrno>
-#include <cstdio>
+#include <algorithm>
 #include <cstdlib>
-#include <cstring>
 #include <format>
+#include <functional>
 #include <map>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <variant>
 #include <vector>
 
 namespace openpower::dump::pel
@@ -34,17 +35,22 @@ constexpr auto opLoggingInterface = "org.open_power.Logging.PEL";
 constexpr auto entryInterface = "xyz.openbmc_project.Logging.Entry";
 constexpr auto opEntryInterface = "org.open_power.Logging.PEL.Entry";
 
-uint32_t createSbeErrorPEL(const std::string& event, const sbeError_t& sbeError,
-                           const FFDCData& ffdcData, const Severity severity,
-                           const std::optional<PELFFDCInfo>& pelFFDCInfoOpt)
+namespace
+{
+
+/**
+ * @brief Builds the CreatePELWithFFDCFiles call of an SBE error
+ *
+ * The FFDC file descriptors are duplicated into the message, the call can
+ * be sent after the error is gone.
+ */
+sdbusplus::message_t newCreatePELCall(
+    sdbusplus::bus_t& bus, const std::string& event, const sbeError_t& sbeError,
+    const FFDCData& ffdcData, const Severity severity,
+    const std::optional<PELFFDCInfo>& pelFFDCInfoOpt)
 {
-    uint32_t plid = 0;
     std::unordered_map<std::string, std::string> additionalData = {
         {"_PID", std::to_string(getpid())}, {"SBE_ERR_MSG", sbeError.what()}};
-    auto bus = sdbusplus::bus::new_default();
-
-    additionalData.emplace("_PID", std::to_string(getpid()));
-    additionalData.emplace("SBE_ERR_MSG", sbeError.what());
 
     for (auto& data : ffdcData)
     {
@@ -70,17 +76,30 @@ uint32_t createSbeErrorPEL(const std::string& event, const sbeError_t& sbeError,
                 FFDCFormat::Custom,
             FFDC_FORMAT_SUBTYPE, FFDC_FORMAT_VERSION, sbeError.getFd()));
     }
+
+    auto service = util::getService(bus, opLoggingInterface, loggingObjectPath);
+    auto method = bus.new_method_call(service.c_str(), loggingObjectPath,
+                                      opLoggingInterface,
+                                      "CreatePELWithFFDCFiles");
+    auto level =
+        sdbusplus::xyz::openbmc_project::Logging::server::convertForMessage(
+            severity);
+    method.append(event, level, additionalData, pelFFDCInfo);
+    return method;
+}
+
+} // namespace
+
+uint32_t createSbeErrorPEL(const std::string& event, const sbeError_t& sbeError,
+                           const FFDCData& ffdcData, const Severity severity,
+                           const std::optional<PELFFDCInfo>& pelFFDCInfoOpt)
+{
+    uint32_t plid = 0;
+    auto& bus = util::getBus();
     try
     {
-        auto service =
-            util::getService(bus, opLoggingInterface, loggingObjectPath);
-        auto method =
-            bus.new_method_call(service.c_str(), loggingObjectPath,
-                                opLoggingInterface, "CreatePELWithFFDCFiles");
-        auto level =
-            sdbusplus::xyz::openbmc_project::Logging::server::convertForMessage(
-                severity);
-        method.append(event, level, additionalData, pelFFDCInfo);
+        auto method = newCreatePELCall(bus, event, sbeError, ffdcData,
+                                       severity, pelFFDCInfoOpt);
         auto response = bus.call(method);
 
         // reply will be tuple containing bmc log id, platform log id
@@ -108,6 +127,109 @@ uint32_t createSbeErrorPEL(const std::string& event, const sbeError_t& sbeError,
     return plid;
 }
 
+PELBatch::PELBatch(size_t maxInFlight) :
+    maxInFlight(std::max<size_t>(maxInFlight, 1))
+{}
+
+void PELBatch::add(const std::string& event, const sbeError_t& sbeError,
+                   const FFDCData& ffdcData, const Severity severity,
+                   const PELFFDCInfo& pelFFDCInfo)
+{
+    try
+    {
+        if (bus == nullptr)
+        {
+            bus = &util::getBus();
+        }
+        requests.push_back(
+            {newCreatePELCall(*bus, event, sbeError, ffdcData, severity,
+                              pelFFDCInfo),
+             std::nullopt, {}});
+        sendPending();
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        lg2::error(
+            "D-Bus call exception OBJPATH={OBJPATH}, INTERFACE={INTERFACE}, "
+            "EXCEPTION={ERROR}",
+            "OBJPATH", loggingObjectPath, "INTERFACE", opLoggingInterface,
+            "ERROR", e);
+        throw;
+    }
+}
+
+std::vector<uint32_t> PELBatch::wait()
+{
+    // A call timing out gets an error reply, so the loop always ends
+    while (inFlight > 0)
+    {
+        if (!bus->process_discard())
+        {
+            bus->wait();
+        }
+    }
+
+    std::vector<uint32_t> logIdList;
+    for (const auto& request : requests)
+    {
+        if (request.logId)
+        {
+            logIdList.push_back(*request.logId);
+        }
+    }
+    requests.clear();
+    sent = 0;
+    return logIdList;
+}
+
+void PELBatch::sendPending()
+{
+    while (inFlight < maxInFlight && sent < requests.size())
+    {
+        auto index = sent;
+        auto& request = requests[index];
+        request.slot = request.method.call_async(
+            [this, index](sdbusplus::message_t& reply) {
+                completed(index, reply);
+            });
+        sent++;
+        inFlight++;
+    }
+}
+
+void PELBatch::completed(size_t index, sdbusplus::message_t& reply)
+{
+    inFlight--;
+    try
+    {
+        if (reply.is_method_error())
+        {
+            throw std::runtime_error("Method error reply");
+        }
+
+        // reply will be tuple containing bmc log id, platform log id
+        auto [logId, pelId] = reply.unpack<uint32_t, uint32_t>();
+        requests[index].logId = logId;
+        lg2::info("Logged PEL {PELID} entry {LOGID}", "PELID", pelId, "LOGID",
+                  logId);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to create PEL, {ERROR}", "ERROR", e);
+    }
+
+    try
+    {
+        sendPending();
+    }
+    catch (const std::exception& e)
+    {
+        // The PELs not sent are dropped, the ones in flight still complete
+        lg2::error("Failed to request PEL, {ERROR}", "ERROR", e);
+        requests.resize(sent);
+    }
+}
+
 openpower::dump::pel::Severity convertSeverityToEnum(uint8_t severity)
 {
     switch (severity)
@@ -123,12 +245,12 @@ openpower::dump::pel::Severity convertSeverityToEnum(uint8_t severity)
     }
 }
 
-std::vector<uint32_t> processFFDCPackets(
-    const openpower::phal::sbeError_t& sbeError, const std::string& event,
-    openpower::dump::pel::FFDCData& pelAdditionalData)
+void processFFDCPackets(const openpower::phal::sbeError_t& sbeError,
+                        const std::string& event,
+                        openpower::dump::pel::FFDCData& pelAdditionalData,
+                        PELBatch& batch)
 {
     const auto& ffdcFileList = sbeError.getFfdcFileList();
-    std::vector<uint32_t> logIdList;
     for (const auto& [slid, ffdcTuple] : ffdcFileList)
     {
         uint8_t severity;
@@ -153,139 +275,135 @@ std::vector<uint32_t> processFFDCPackets(
                                 Create::FFDCFormat::Custom,
                             FFDC_FORMAT_SUBTYPE, FFDC_FORMAT_VERSION, fd));
 
-        auto logId = openpower::dump::pel::createSbeErrorPEL(
-            event, sbeError, pelAdditionalData, logSeverity);
-        lg2::info("Logged PEL {PELID} for SLID {SLID}", "PELID", logId, "SLID",
-                  slid);
-        logIdList.push_back(logId);
+        batch.add(event, sbeError, pelAdditionalData, logSeverity, pelFFDCInfo);
+        lg2::info("Requested PEL for SLID {SLID}", "SLID", slid);
     }
-    return logIdList;
 }
 
 std::tuple<uint32_t, std::string> getLogInfo(uint32_t logId)
 {
-    uint32_t pelId;
-    std::string src;
-    try
-    {
-        auto bus = sdbusplus::bus::new_default();
-        const auto loggingEntryObjectPath =
-            std::string(loggingObjectPath) + "/entry/" + std::to_string(logId);
-        auto service =
-            util::getService(bus, entryInterface, loggingEntryObjectPath);
-        auto method =
-            bus.new_method_call(service.c_str(), loggingEntryObjectPath.c_str(),
-                                "org.freedesktop.DBus.Properties", "Get");
-        method.append(opEntryInterface);
-        method.append("PlatformLogID");
-        auto response = bus.call(method);
-        auto v = response.unpack<std::variant<uint32_t, std::string>>();
-
-        pelId = std::get<uint32_t>(v);
-        method =
-            bus.new_method_call(service.c_str(), loggingEntryObjectPath.c_str(),
-                                "org.freedesktop.DBus.Properties", "Get");
-        method.append(entryInterface);
-        method.append("EventId");
-        response = bus.call(method);
-        response.read(v);
-        std::istringstream iss(std::get<std::string>(v));
-        iss >> src;
-    }
-    catch (const sdbusplus::exception_t& e)
-    {
-        lg2::error("D-Bus call exception "
-                   "EXCEPTION={ERROR}",
-                   "ERROR", e);
-        throw;
-    }
-    catch (const std::exception& e)
+    auto logInfos = getLogInfos({logId});
+    auto it = logInfos.find(logId);
+    if (it == logInfos.end())
     {
-        throw;
+        throw std::runtime_error(
+            std::format("Failed to get the info of log entry {}", logId));
     }
-
-    return std::tuple<uint32_t, std::string>(pelId, src);
-}
-
-FFDCFile::FFDCFile(const json& pHALCalloutData) :
-    calloutData(pHALCalloutData.dump()),
-    calloutFile("/tmp/phalPELCalloutsJson.XXXXXX"), fileFD(-1)
-{
-    prepareFFDCFile();
+    return it->second;
 }
 
-FFDCFile::~FFDCFile()
+std::map<uint32_t, std::tuple<uint32_t, std::string>>
+    getLogInfos(const std::vector<uint32_t>& logIds)
 {
-    removeCalloutFile();
-}
+    using PropertyValue = std::variant<uint32_t, std::string>;
 
-int FFDCFile::getFileFD() const
-{
-    return fileFD;
-}
-
-void FFDCFile::prepareFFDCFile()
-{
-    createCalloutFile();
-    writeCalloutData();
-    setCalloutFileSeekPos();
-}
-
-void FFDCFile::createCalloutFile()
-{
-    fileFD = mkostemp(const_cast<char*>(calloutFile.c_str()), O_RDWR);
-
-    if (fileFD == -1)
+    std::map<uint32_t, std::tuple<uint32_t, std::string>> logInfos;
+    if (logIds.empty())
     {
-        lg2::error("Failed to create phalPELCallouts file({FILE}), "
-                   "errorno({ERRNO}) and errormsg({ERRORMSG})",
-                   "FILE", calloutFile, "ERRNO", errno, "ERRORMSG",
-                   strerror(errno));
-        throw std::runtime_error("Failed to create phalPELCallouts file");
+        return logInfos;
     }
-}
 
-void FFDCFile::writeCalloutData()
-{
-    ssize_t rc = write(fileFD, calloutData.c_str(), calloutData.size());
+    auto entryPath = [](uint32_t logId) {
+        return std::string(loggingObjectPath) + "/entry/" +
+               std::to_string(logId);
+    };
+
+    auto& bus = util::getBus();
+    // Every entry is hosted by the logging service
+    auto service =
+        util::getService(bus, entryInterface, entryPath(logIds.front()));
+
+    std::map<uint32_t, std::optional<uint32_t>> pelIds;
+    std::map<uint32_t, std::optional<std::string>> srcs;
+    size_t outstanding = 0;
+    std::vector<sdbusplus::slot_t> slots;
+
+    auto get = [&](uint32_t logId, const char* intf, const char* property,
+                   std::function<void(PropertyValue&)> store) {
+        auto path = entryPath(logId);
+        auto method = bus.new_method_call(service.c_str(), path.c_str(),
+                                          "org.freedesktop.DBus.Properties",
+                                          "Get");
+        method.append(intf, property);
+        slots.emplace_back(method.call_async(
+            [&outstanding, logId, property,
+             store = std::move(store)](sdbusplus::message_t& reply) {
+                outstanding--;
+                try
+                {
+                    if (reply.is_method_error())
+                    {
+                        throw std::runtime_error("Method error reply");
+                    }
+                    auto value = reply.unpack<PropertyValue>();
+                    store(value);
+                }
+                catch (const std::exception& e)
+                {
+                    lg2::error("Failed to get {PROPERTY} of log entry "
+                               "{LOGID}, {ERROR}",
+                               "PROPERTY", property, "LOGID", logId, "ERROR",
+                               e);
+                }
+            }));
+        outstanding++;
+    };
 
-    if (rc == -1)
+    try
     {
-        lg2::error("Failed to write phaPELCallout info in file({FILE}), "
-                   "errorno({ERRNO}), errormsg({ERRORMSG})",
-                   "FILE", calloutFile, "ERRNO", errno, "ERRORMSG",
-                   strerror(errno));
-        throw std::runtime_error("Failed to write phalPELCallouts info");
+        for (auto logId : logIds)
+        {
+            get(logId, opEntryInterface, "PlatformLogID",
+                [&pelIds, logId](PropertyValue& value) {
+                    pelIds[logId] = std::get<uint32_t>(value);
+                });
+            get(logId, entryInterface, "EventId",
+                [&srcs, logId](PropertyValue& value) {
+                    std::string src;
+                    std::istringstream iss(std::get<std::string>(value));
+                    iss >> src;
+                    srcs[logId] = src;
+                });
+        }
+
+        // The replies arrive in any order, a call timing out gets an error
+        // reply so the loop always ends
+        while (outstanding > 0)
+        {
+            if (!bus.process_discard())
+            {
+                bus.wait();
+            }
+        }
     }
-    else if (rc != static_cast<ssize_t>(calloutData.size()))
+    catch (const sdbusplus::exception_t& e)
     {
-        lg2::warning("Could not write all phal callout info in file({FILE}), "
-                     "written byte({WRITTEN}), total byte({TOTAL})",
-                     "FILE", calloutFile, "WRITTEN", rc, "TOTAL",
-                     calloutData.size());
+        lg2::error("D-Bus call exception "
+                   "EXCEPTION={ERROR}",
+                   "ERROR", e);
+        throw;
     }
-}
-
-void FFDCFile::setCalloutFileSeekPos()
-{
-    int rc = lseek(fileFD, 0, SEEK_SET);
 
-    if (rc == -1)
+    for (auto logId : logIds)
     {
-        lg2::error("Failed to set SEEK_SET for phalPELCallouts in "
-                   "file({FILE}), errorno({ERRNO}), errormsg({ERRORMSG})",
-                   "FILE", calloutFile, "ERRNO", errno, "ERRORMSG",
-                   strerror(errno));
-
-        throw std::runtime_error(
-            "Failed to set SEEK_SET for phalPELCallouts file");
+        if (pelIds[logId] && srcs[logId])
+        {
+            logInfos.emplace(logId,
+                             std::make_tuple(*pelIds[logId], *srcs[logId]));
+        }
     }
+    return logInfos;
 }
 
-void FFDCFile::removeCalloutFile()
+FFDCFile::FFDCFile(const json& pHALCalloutData) :
+    buffer(pHALCalloutData.dump())
+{}
+
+FFDCFile::~FFDCFile() = default;
+
+int FFDCFile::getFileFD() const
 {
-    close(fileFD);
-    std::remove(calloutFile.c_str());
+    return buffer.getFileDescriptor();
 }
 
 } // namespace openpower::dump::pel
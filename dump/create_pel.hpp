@@ -1,12 +1,18 @@
 #pragma once
 
+#include "ffdc_buffer.hpp"
 #include "xyz/openbmc_project/Logging/Entry/server.hpp"
 
 #include <phal_exception.H>
 
 #include <nlohmann/json.hpp>
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/message.hpp>
 #include <xyz/openbmc_project/Logging/Create/server.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <map>
 #include <optional>
 #include <string>
 #include <tuple>
@@ -50,17 +56,104 @@ uint32_t createSbeErrorPEL(
 openpower::dump::pel::Severity convertSeverityToEnum(uint8_t severity);
 
 /**
- * @brief Process FFDC packets and create PELs for each packet.
+ * @class PELBatch
+ * @brief Creates PELs with asynchronous calls, a bounded number in flight.
+ *
+ * The calls are sent as the PELs are added and the replies are processed
+ * by wait(), the caller can do other work meanwhile. The batch uses the
+ * connection of the thread adding the PELs and must stay on that thread.
+ */
+class PELBatch
+{
+  public:
+    /** @brief Default number of PEL creations in flight */
+    static constexpr size_t defaultMaxInFlight = 4;
+
+    PELBatch(const PELBatch&) = delete;
+    PELBatch& operator=(const PELBatch&) = delete;
+    PELBatch(PELBatch&&) = delete;
+    PELBatch& operator=(PELBatch&&) = delete;
+    ~PELBatch() = default;
+
+    /**
+     * @param[in] maxInFlight - Most PEL creations in flight at once
+     */
+    explicit PELBatch(size_t maxInFlight = defaultMaxInFlight);
+
+    /**
+     * @brief Adds a PEL to the batch, sent at once if a slot is free.
+     *
+     * The FFDC file descriptors are duplicated, the error can be released
+     * before the PEL is created.
+     *
+     * @param[in] event - The event identifier
+     * @param[in] sbeError - The SBE error
+     * @param[in] ffdcData - Additional data of the PEL
+     * @param[in] severity - Severity of the PEL
+     * @param[in] pelFFDCInfo - FFDC files of the PEL
+     */
+    void add(const std::string& event, const sbeError_t& sbeError,
+             const FFDCData& ffdcData, const Severity severity,
+             const PELFFDCInfo& pelFFDCInfo);
+
+    /**
+     * @brief Waits for every PEL of the batch to be created.
+     *
+     * A failed creation is logged and left out, the batch is empty again
+     * on return.
+     *
+     * @return logIdList - List of Errors created, in the order added
+     */
+    std::vector<uint32_t> wait();
+
+  private:
+    /** @brief A PEL of the batch */
+    struct Request
+    {
+        sdbusplus::message_t method;
+        std::optional<uint32_t> logId;
+        sdbusplus::slot_t slot;
+    };
+
+    /** @brief Connection of the thread, opened by the first PEL */
+    sdbusplus::bus_t* bus = nullptr;
+
+    /** @brief Most PEL creations in flight at once */
+    size_t maxInFlight;
+
+    /** @brief The PELs in the order added */
+    std::vector<Request> requests;
+
+    /** @brief Number of requests sent, they are sent in order */
+    size_t sent = 0;
+
+    /** @brief Number of requests waiting for their reply */
+    size_t inFlight = 0;
+
+    /**
+     * @brief Sends requests while a slot is free.
+     */
+    void sendPending();
+
+    /**
+     * @brief Records the reply of a request and sends the next one.
+     */
+    void completed(size_t index, sdbusplus::message_t& reply);
+};
+
+/**
+ * @brief Process FFDC packets and add a PEL for each packet to a batch.
  *
  * @param[in] sbeError - An SBE error object containing FFDC packet information.
  * @param[in] event - The event identifier associated with the PELs.
  * @param[out] pelAdditionalData - A reference to additional PEL data to be
  *                                 included in the PEL.
- * @return logIdList - List of Errors created
+ * @param[in] batch - The batch creating the PELs, wait() returns their ids
  */
-std::vector<uint32_t> processFFDCPackets(
-    const openpower::phal::sbeError_t& sbeError, const std::string& event,
-    openpower::dump::pel::FFDCData& pelAdditionalData);
+void processFFDCPackets(const openpower::phal::sbeError_t& sbeError,
+                        const std::string& event,
+                        openpower::dump::pel::FFDCData& pelAdditionalData,
+                        PELBatch& batch);
 
 /**
  * @brief Get PEL Id and Reason Code for a given logEntry
@@ -71,6 +164,21 @@ std::vector<uint32_t> processFFDCPackets(
  */
 std::tuple<uint32_t, std::string> getLogInfo(uint32_t logId);
 
+/**
+ * @brief Get PEL Id and Reason Code for many logEntries at once
+ *
+ * The property reads of all the entries are sent before any reply is
+ * awaited, so the batch costs about one round trip to the logging service
+ * whatever its size.
+ *
+ * @param[in] logIds - dbus entry ids.
+ *
+ * @return Platform Event Log Id and Reason Code keyed by entry id, an entry
+ *         that could not be read is logged and left out
+ */
+std::map<uint32_t, std::tuple<uint32_t, std::string>>
+    getLogInfos(const std::vector<uint32_t>& logIds);
+
 /**
  * @class FFDCFile
  * @brief This class is used to create ffdc data file and to get fd
@@ -91,7 +199,7 @@ class FFDCFile
     explicit FFDCFile(const json& pHALCalloutData);
 
     /**
-     * Used to remove created ffdc file.
+     * Used to close the ffdc file, which releases it.
      */
     ~FFDCFile();
 
@@ -104,55 +212,10 @@ class FFDCFile
 
   private:
     /**
-     * Used to store callout ffdc data from passed json object.
-     */
-    std::string calloutData;
-
-    /**
-     * Used to store unique ffdc file name.
-     */
-    std::string calloutFile;
-
-    /**
-     * Used to store created ffdc file descriptor id.
-     */
-    int fileFD;
-
-    /**
-     * Used to create ffdc file to pass PEL api for creating
-     * pel records.
-     *
-     * @return NULL
-     */
-    void prepareFFDCFile();
-
-    /**
-     * Create unique ffdc file.
-     *
-     * @return NULL
-     */
-    void createCalloutFile();
-
-    /**
-     * Used write json object value into created file.
-     *
-     * @return NULL
-     */
-    void writeCalloutData();
-
-    /**
-     * Used set ffdc file seek position beginning to consume by PEL
-     *
-     * @return NULL
-     */
-    void setCalloutFileSeekPos();
-
-    /**
-     * Used to remove created ffdc file.
-     *
-     * @return NULL
+     * Used to store the callout ffdc data in memory, the file has no path
+     * and is released when closed.
      */
-    void removeCalloutFile();
+    openpower::common::FFDCBuffer buffer;
 
 }; // FFDCFile end
 
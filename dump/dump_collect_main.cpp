@@ -1,14 +1,98 @@
+#include "collect_service.hpp"
+#include "dump_engine.hpp"
+#include "dump_utils.hpp"
 #include "sbe_consts.hpp"
 #include "sbe_dump_collector.hpp"
+#include "service_cache.hpp"
 
 #include <libphal.H>
 
 #include <CLI/App.hpp>
 #include <CLI/Config.hpp>
 #include <CLI/Formatter.hpp>
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/bus.hpp>
+#include <sdeventplus/event.hpp>
 
+#include <chrono>
 #include <filesystem>
 #include <iostream>
+#include <memory>
+
+namespace
+{
+
+using openpower::dump::sbe_chipop::SbeDumpCollector;
+
+/** @brief Longest a collection requested from the daemon may take */
+constexpr auto collectTimeout = std::chrono::hours(2);
+
+/**
+ * @brief Serves the Collect method until the process is stopped. pdbg and
+ * libekb are initialized before the bus name is taken.
+ */
+int runDaemon(std::unique_ptr<SbeDumpCollector> collector)
+{
+    using namespace openpower::dump;
+
+    try
+    {
+        collector->initialize();
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to initialize the collector, {ERROR}", "ERROR", e);
+        return EXIT_FAILURE;
+    }
+
+    auto event = sdeventplus::Event::get_default();
+    auto& bus = util::getBus();
+    bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
+
+    DumpEngine engine(event, std::move(collector));
+    CollectService service(bus, engine);
+    lg2::info("Dump collector ready");
+    return event.loop();
+}
+
+/**
+ * @brief Whether the dump-collect daemon owns its bus name.
+ */
+bool daemonRunning(sdbusplus::bus_t& bus)
+{
+    try
+    {
+        auto method = bus.new_method_call(
+            "org.freedesktop.DBus", "/org/freedesktop/DBus",
+            "org.freedesktop.DBus", "NameHasOwner");
+        method.append(openpower::dump::collectorBusName);
+        return bus.call(method).unpack<bool>();
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to look for the dump collector, {ERROR}", "ERROR",
+                   e);
+    }
+    return false;
+}
+
+/**
+ * @brief Has the daemon collect the dump, waits for the collection.
+ */
+void collectFromDaemon(sdbusplus::bus_t& bus, uint8_t type, uint32_t id,
+                       uint32_t failingUnit, const std::filesystem::path& path,
+                       uint32_t deadline)
+{
+    using namespace openpower::dump;
+
+    auto method = bus.new_method_call(collectorBusName, collectorObjectPath,
+                                      collectorInterface, "Collect");
+    method.append(type, id, failingUnit,
+                  std::filesystem::absolute(path).string(), deadline);
+    bus.call(method, collectTimeout);
+}
+
+} // namespace
 
 int main(int argc, char** argv)
 {
@@ -24,24 +108,65 @@ int main(int argc, char** argv)
         "specific options based on the dump type.");
 
     int type = 0;
-    uint32_t id;
+    uint32_t id = 0;
     std::string pathStr;
     std::optional<uint64_t> failingUnit;
+    OcmbConcurrency ocmbConcurrency;
+    size_t workers = 0;
+    std::string compression = "none";
+    unsigned nestedDumpWait = 0;
+    uint32_t deadline = 0;
+    bool daemon = false;
+    bool local = false;
+    bool trace = false;
 
-    app.add_option("--type, -t", type, "Type of the dump")
-        ->required()
-        ->check(CLI::IsMember(
-            {SBE_DUMP_TYPE_HARDWARE, SBE_DUMP_TYPE_HOSTBOOT, SBE_DUMP_TYPE_SBE,
-             SBE_DUMP_TYPE_PERFORMANCE, SBE_DUMP_TYPE_MSBE}));
+    auto typeOption = app.add_option("--type, -t", type, "Type of the dump");
+    typeOption->check(CLI::IsMember(
+        {SBE_DUMP_TYPE_HARDWARE, SBE_DUMP_TYPE_HOSTBOOT, SBE_DUMP_TYPE_SBE,
+         SBE_DUMP_TYPE_PERFORMANCE, SBE_DUMP_TYPE_MSBE}));
 
-    app.add_option("--id, -i", id, "ID of the dump")->required();
+    auto idOption = app.add_option("--id, -i", id, "ID of the dump");
 
-    app.add_option("--path, -p", pathStr,
-                   "Path to store the collected dump files")
-        ->required();
+    auto pathOption = app.add_option("--path, -p", pathStr,
+                                     "Path to store the collected dump files");
 
     app.add_option("--failingunit, -f", failingUnit, "ID of the failing unit");
 
+    app.add_option("--ocmb-concurrency", ocmbConcurrency.perProc,
+                   "Maximum OCMB dumps collected at once on each proc")
+        ->check(CLI::PositiveNumber);
+
+    app.add_option("--ocmb-link-concurrency", ocmbConcurrency.perLink,
+                   "Maximum OCMB dumps collected at once on each FSI link")
+        ->check(CLI::PositiveNumber);
+
+    app.add_option("--workers", workers,
+                   "Number of collection threads, 0 to size from the cores");
+
+    app.add_option("--compress", compression,
+                   "Compression applied to the dump files as they are written")
+        ->check(CLI::IsMember({"none", "gzip"}));
+
+    app.add_option("--nested-dump-wait", nestedDumpWait,
+                   "Seconds to wait at the end for the SBE dumps requested "
+                   "by chip-op timeouts, 0 to not wait");
+
+    app.add_option("--deadline", deadline,
+                   "Seconds allowed for a hardware or hostboot dump, the "
+                   "chips not done in time are abandoned, 0 for no limit");
+
+    auto daemonFlag = app.add_flag(
+        "--daemon", daemon,
+        "Initialize once and collect the dumps requested over D-Bus");
+
+    app.add_flag("--local", local,
+                 "Collect in this process, fails if the daemon is running")
+        ->excludes(daemonFlag);
+
+    app.add_flag("--trace", trace,
+                 "Write the steps of each collection thread in trace.json, "
+                 "not available through the daemon");
+
     try
     {
         CLI11_PARSE(app, argc, argv);
@@ -51,6 +176,26 @@ int main(int argc, char** argv)
         return app.exit(e);
     }
 
+    auto dumpCollector = std::make_unique<SbeDumpCollector>();
+    dumpCollector->setOcmbConcurrency(ocmbConcurrency);
+    dumpCollector->setWorkerCount(workers);
+    dumpCollector->setCompression(compression == "gzip"
+                                      ? openpower::dump::DumpCompression::gzip
+                                      : openpower::dump::DumpCompression::none);
+    dumpCollector->setNestedDumpWait(std::chrono::seconds(nestedDumpWait));
+    dumpCollector->setTrace(trace);
+
+    if (daemon)
+    {
+        return runDaemon(std::move(dumpCollector));
+    }
+
+    if (!typeOption->count() || !idOption->count() || !pathOption->count())
+    {
+        std::cerr << "--type, --id and --path are required\n";
+        return EXIT_FAILURE;
+    }
+
     if (((type == SBE_DUMP_TYPE_HARDWARE) || (type == SBE_DUMP_TYPE_SBE) ||
          (type == SBE_DUMP_TYPE_MSBE)) &&
         !failingUnit.has_value())
@@ -67,17 +212,54 @@ int main(int argc, char** argv)
         std::filesystem::create_directories(dirPath);
     }
 
-    SbeDumpCollector dumpCollector;
-
     auto failingUnitId = 0xFFFFFF; // Default or unspecified value
     if (failingUnit.has_value())
     {
         failingUnitId = failingUnit.value();
     }
 
+    // A collection here would run chip-ops along with the daemon, which
+    // collects with the settings it was started with
+    const OcmbConcurrency defaultConcurrency;
+    bool ownSettings =
+        trace || compression != "none" || workers != 0 ||
+        nestedDumpWait != 0 ||
+        ocmbConcurrency.perProc != defaultConcurrency.perProc ||
+        ocmbConcurrency.perLink != defaultConcurrency.perLink;
+    auto& bus = openpower::dump::util::getBus();
+    if (daemonRunning(bus))
+    {
+        if (local)
+        {
+            std::cerr << "The dump collector daemon is running, stop it to "
+                         "collect with --local\n";
+            return EXIT_FAILURE;
+        }
+        if (ownSettings)
+        {
+            std::cerr << "The dump collector daemon collects with its own "
+                         "settings, stop it to collect with --trace, "
+                         "--workers, --compress, --nested-dump-wait or an "
+                         "OCMB concurrency\n";
+            return EXIT_FAILURE;
+        }
+        try
+        {
+            collectFromDaemon(bus, type, id, failingUnitId, dirPath,
+                              deadline);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to collect dump: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return 0;
+    }
+
     try
     {
-        dumpCollector.collectDump(type, id, failingUnitId, pathStr);
+        dumpCollector->collectDump(type, id, failingUnitId, pathStr,
+                                   std::chrono::seconds(deadline));
     }
     catch (const std::exception& e)
     {
@@ -85,5 +267,9 @@ int main(int argc, char** argv)
         std::exit(EXIT_FAILURE);
     }
 
+    auto& serviceCache = openpower::dump::util::ServiceCache::instance();
+    lg2::info("Service lookups: {HITS} cached, {MISSES} from the mapper",
+              "HITS", serviceCache.hits(), "MISSES", serviceCache.misses());
+
     return 0;
 }
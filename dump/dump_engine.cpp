@@ -0,0 +1,401 @@
+#include "dump_engine.hpp"
+
+#include "dump_package.hpp"
+#include "dump_utils.hpp"
+#include "sbe_consts.hpp"
+#include "service_cache.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/bus.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <variant>
+
+namespace openpower::dump
+{
+
+namespace
+{
+
+constexpr auto inventoryManager = "xyz.openbmc_project.Inventory.Manager";
+constexpr auto inventorySystem = "/xyz/openbmc_project/inventory/system";
+constexpr auto assetInterface = "xyz.openbmc_project.Inventory.Decorator.Asset";
+constexpr auto dumpManager = "xyz.openbmc_project.Dump.Manager";
+constexpr auto progressInterface = "xyz.openbmc_project.Common.Progress";
+
+/** @brief Directory holding the dump contents while they are collected */
+constexpr auto contentRoot = "/tmp";
+
+/**
+ * @brief Reads a D-Bus property.
+ *
+ * @return The value, or nothing if it cannot be read
+ */
+template <typename T>
+std::optional<T> readProperty(sdbusplus::bus_t& bus, const char* service,
+                              const std::string& path, const char* interface,
+                              const char* property)
+{
+    try
+    {
+        auto method = bus.new_method_call(service, path.c_str(),
+                                          "org.freedesktop.DBus.Properties",
+                                          "Get");
+        method.append(interface, property);
+        auto reply = bus.call(method);
+        std::variant<T> value;
+        reply.read(value);
+        return std::get<T>(value);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to read {PROPERTY} of {PATH}, {ERROR}", "PROPERTY",
+                   property, "PATH", path, "ERROR", e);
+    }
+    return std::nullopt;
+}
+
+/** @brief System serial number, padded to 7 characters */
+std::string systemSerial(sdbusplus::bus_t& bus)
+{
+    auto serial = readProperty<std::string>(bus, inventoryManager,
+                                            inventorySystem, assetInterface,
+                                            "SerialNumber")
+                      .value_or("");
+    if (serial.empty() || !std::ranges::all_of(serial, [](unsigned char c) {
+            return std::isalnum(c);
+        }))
+    {
+        return "0000000";
+    }
+    if (serial.size() < 7)
+    {
+        serial.insert(0, 7 - serial.size(), '0');
+    }
+    return serial;
+}
+
+/** @brief System model */
+std::string systemModel(sdbusplus::bus_t& bus)
+{
+    auto model = readProperty<std::string>(bus, inventoryManager,
+                                           inventorySystem, assetInterface,
+                                           "Model")
+                     .value_or("");
+    return model.empty() ? "00000000" : model;
+}
+
+/** @brief Formats a time in the local time zone */
+std::string formatTime(std::time_t time, const char* format)
+{
+    std::tm tm{};
+    localtime_r(&time, &tm);
+    char buffer[32] = {};
+    std::strftime(buffer, sizeof(buffer), format, &tm);
+    return buffer;
+}
+
+/** @brief VERSION_ID of the BMC image */
+std::string driverVersion()
+{
+    std::ifstream osRelease("/etc/os-release");
+    std::string line;
+    while (std::getline(osRelease, line))
+    {
+        if (line.starts_with("VERSION_ID="))
+        {
+            auto value = line.substr(line.find('=') + 1);
+            return value.substr(0, value.find_first_of("()"));
+        }
+    }
+    return {};
+}
+
+/** @brief Appends the lines of a file to the dump info */
+void appendFile(std::ofstream& info, const std::filesystem::path& file)
+{
+    std::ifstream in(file);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        info << line << "\n";
+    }
+}
+
+/**
+ * @brief Writes info.yaml, the description of the dump read by the
+ * service tools.
+ *
+ * @param[in] bus - Bus used to read the dump entry
+ * @param[in] entryPath - Object path of the dump entry
+ * @param[in] contentDir - Directory with plat_dump/
+ */
+void writeDumpInfo(sdbusplus::bus_t& bus, const std::string& entryPath,
+                   const std::filesystem::path& contentDir)
+{
+    auto now = static_cast<uint64_t>(std::time(nullptr));
+    auto start = readProperty<uint64_t>(bus, dumpManager, entryPath,
+                                        progressInterface, "StartTime")
+                     .value_or(0);
+    auto end = readProperty<uint64_t>(bus, dumpManager, entryPath,
+                                      progressInterface, "CompletedTime")
+                   .value_or(0);
+
+    std::ofstream info(contentDir / "info.yaml");
+    info << "# SPDX-License-Identifier: GPL-2.0\n"
+         << "%YAML 1.2\n"
+         << "---\n\n"
+         << "generation: p10\n"
+         << "driver: " << driverVersion() << "\n"
+         << "dump-start-time: "
+         << formatTime(start != 0 ? start : now, "%Y-%m-%d %H:%M:%S") << "\n"
+         << "dump-end-time: "
+         << formatTime(end != 0 ? end : now, "%Y-%m-%d %H:%M:%S") << "\n";
+
+    auto additionalData = contentDir / "plat_dump" / "additional_data";
+    if (std::filesystem::is_directory(additionalData))
+    {
+        std::vector<std::filesystem::path> entries;
+        for (const auto& entry :
+             std::filesystem::directory_iterator(additionalData))
+        {
+            entries.push_back(entry.path());
+        }
+        std::ranges::sort(entries);
+        for (const auto& entry : entries)
+        {
+            appendFile(info, entry);
+        }
+    }
+
+    // Errors logged by the collector while collecting the dump, written
+    // next to plat_dump where gendumpinfo reads them
+    auto errorInfo = contentDir / "errorInfo";
+    if (std::filesystem::exists(errorInfo))
+    {
+        appendFile(info, errorInfo);
+    }
+
+    if (!info)
+    {
+        throw std::runtime_error("Failed to write the dump info");
+    }
+}
+
+/** @brief Asks for the BMC dump associated with a system dump */
+void requestBmcDump(sdbusplus::bus_t& bus)
+{
+    try
+    {
+        auto method = bus.new_method_call(dumpManager,
+                                          "/xyz/openbmc_project/dump/bmc",
+                                          "xyz.openbmc_project.Dump.Create",
+                                          "CreateDump");
+        method.append(util::DumpCreateParams{});
+        bus.call(method);
+        lg2::info("BMC dump initiated");
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Error in creating BMC dump associated with system dump, "
+                   "{ERROR}",
+                   "ERROR", e);
+    }
+}
+
+} // namespace
+
+DumpEngine::DumpEngine(
+    const sdeventplus::Event& event,
+    std::unique_ptr<sbe_chipop::SbeDumpCollector> collector) :
+    collector(std::move(collector))
+{
+    eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (eventFd == -1)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to create the dump eventfd");
+    }
+    eventSource = std::make_unique<sdeventplus::source::IO>(
+        event, eventFd, EPOLLIN,
+        [this](sdeventplus::source::IO&, int, uint32_t) { dispatch(); });
+}
+
+DumpEngine::~DumpEngine()
+{
+    eventSource.reset();
+    for (auto& [job, worker] : jobs)
+    {
+        worker.first.join();
+    }
+    close(eventFd);
+}
+
+void DumpEngine::start(DumpRequest request, Completion completion)
+{
+    startJob([this, request = std::move(request)]() { return run(request); },
+             std::move(completion));
+}
+
+void DumpEngine::collect(uint8_t type, uint32_t id, uint32_t failingUnit,
+                         std::filesystem::path path,
+                         std::chrono::seconds deadline, Completion completion)
+{
+    startJob(
+        [this, type, id, failingUnit, path = std::move(path), deadline]() {
+            try
+            {
+                collector->collectDump(type, id, failingUnit, path, deadline);
+                return true;
+            }
+            catch (const std::exception& e)
+            {
+                lg2::error("Failed to collect dump {ID} in {PATH}, {ERROR}",
+                           "ID", id, "PATH", path, "ERROR", e);
+            }
+            return false;
+        },
+        std::move(completion));
+}
+
+void DumpEngine::startJob(std::function<bool()> work, Completion completion)
+{
+    auto job = nextJob++;
+    std::thread worker([this, job, work = std::move(work)]() {
+        bool success = work();
+        {
+            std::lock_guard lock(mutex);
+            finished.push_back({job, success});
+        }
+        uint64_t one = 1;
+        if (write(eventFd, &one, sizeof(one)) == -1)
+        {
+            lg2::error("Failed to signal the dump completion, {ERRNO}",
+                       "ERRNO", errno);
+        }
+    });
+
+    // The completion is dispatched from the event loop, so it cannot run
+    // before the job is recorded
+    jobs.emplace(job, std::make_pair(std::move(worker), std::move(completion)));
+}
+
+void DumpEngine::dispatch()
+{
+    uint64_t count = 0;
+    if (read(eventFd, &count, sizeof(count)) == -1 && errno != EAGAIN)
+    {
+        lg2::error("Failed to read the dump eventfd, {ERRNO}", "ERRNO", errno);
+    }
+
+    std::vector<Finished> done;
+    {
+        std::lock_guard lock(mutex);
+        done.swap(finished);
+    }
+
+    for (const auto& [job, success] : done)
+    {
+        auto it = jobs.find(job);
+        if (it == jobs.end())
+        {
+            continue;
+        }
+        it->second.first.join();
+        auto completion = std::move(it->second.second);
+        jobs.erase(it);
+        completion(success);
+    }
+}
+
+bool DumpEngine::run(const DumpRequest& request)
+{
+    using namespace openpower::dump::SBE;
+
+    auto now = std::time(nullptr);
+    auto timestamp = formatTime(now, "%Y%m%d%H%M%S");
+    auto contentDir =
+        std::filesystem::path(contentRoot) /
+        ("dump_" + request.dumpId + "_" + std::to_string(now));
+
+    lg2::info("Collecting dump {PATH} in {DIR}", "PATH", request.path, "DIR",
+              contentDir);
+    try
+    {
+        if (!request.failingUnit.has_value() &&
+            ((request.dumpType == SBE_DUMP_TYPE_HARDWARE) ||
+             (request.dumpType == SBE_DUMP_TYPE_SBE) ||
+             (request.dumpType == SBE_DUMP_TYPE_MSBE)))
+        {
+            throw std::invalid_argument(
+                "Failing unit ID is required for Hardware and SBE type dumps");
+        }
+
+        auto platDump = contentDir / "plat_dump";
+        std::filesystem::create_directories(platDump);
+
+        auto& bus = util::getBus();
+        auto serial = systemSerial(bus);
+
+        collector->collectDump(request.dumpType,
+                               std::stoul(request.dumpId, nullptr, 16),
+                               request.failingUnit.value_or(0xFFFFFF),
+                               platDump, request.deadline);
+
+        writeDumpInfo(bus, request.path, contentDir);
+
+        package::PackageRequest packageRequest;
+        packageRequest.contentDir = contentDir;
+        packageRequest.output =
+            request.outputDir / ("SYSDUMP." + serial + "." + request.dumpId +
+                                 "." + timestamp);
+        packageRequest.header.dumpId = request.dumpId;
+        if (request.eid.has_value())
+        {
+            char eid[9] = {};
+            std::snprintf(eid, sizeof(eid), "%08X", *request.eid);
+            packageRequest.header.eid = eid;
+        }
+        packageRequest.header.serial = serial;
+        packageRequest.header.model = systemModel(bus);
+        packageRequest.header.timestamp = timestamp;
+        char hostname[HOST_NAME_MAX + 1] = {};
+        gethostname(hostname, sizeof(hostname) - 1);
+        packageRequest.header.systemName = hostname;
+
+        std::filesystem::create_directories(request.outputDir);
+        package::packageDump(packageRequest);
+        std::filesystem::remove_all(contentDir);
+
+        auto& serviceCache = util::ServiceCache::instance();
+        lg2::info("Dump packaged {FILE}, service lookups: {HITS} cached, "
+                  "{MISSES} from the mapper",
+                  "FILE", packageRequest.output, "HITS", serviceCache.hits(),
+                  "MISSES", serviceCache.misses());
+        requestBmcDump(bus);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to collect dump {PATH}, {ERROR}", "PATH",
+                   request.path, "ERROR", e);
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(contentDir, ec);
+    return false;
+}
+
+} // namespace openpower::dump
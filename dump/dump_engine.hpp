@@ -0,0 +1,174 @@
+#pragma once
+
+#include "sbe_dump_collector.hpp"
+
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openpower::dump
+{
+
+/**
+ * @struct DumpRequest
+ * @brief Parameters of a system dump collected by the engine.
+ */
+struct DumpRequest
+{
+    /** @brief Object path of the dump entry */
+    std::string path;
+
+    /** @brief Dump id, 8 hex digits */
+    std::string dumpId;
+
+    /** @brief Type of the dump, one of the SBE_DUMP_TYPE_* values */
+    uint32_t dumpType = 0;
+
+    /** @brief Error log id associated with the dump, if any */
+    std::optional<uint32_t> eid;
+
+    /** @brief Id of the failing unit, if any */
+    std::optional<uint32_t> failingUnit;
+
+    /** @brief Directory receiving the packaged dump */
+    std::filesystem::path outputDir;
+
+    /** @brief Time allowed for a hardware or hostboot collection, 0 for no
+     * limit */
+    std::chrono::seconds deadline{0};
+};
+
+/**
+ * @class DumpEngine
+ * @brief Collects and packages system dumps in the monitor process.
+ *
+ * Does what opdreport and dump-collect do for a dump, without starting
+ * any process: every dump runs on its own thread through a collector shared
+ * by all the dumps, so pdbg is initialized once. Completions are handed
+ * back to the event loop thread through an eventfd. The dump-collect
+ * daemon uses it to collect the dump files only.
+ */
+class DumpEngine
+{
+  public:
+    /** @brief Called on the event loop thread once a dump is done */
+    using Completion = std::function<void(bool success)>;
+
+    DumpEngine() = delete;
+    DumpEngine(const DumpEngine&) = delete;
+    DumpEngine& operator=(const DumpEngine&) = delete;
+    DumpEngine(DumpEngine&&) = delete;
+    DumpEngine& operator=(DumpEngine&&) = delete;
+
+    /**
+     * @brief Creates the engine.
+     *
+     * @param[in] event - Event loop receiving the completions
+     * @param[in] collector - Collector used for every dump
+     *
+     * Exceptions: std::system_error if the eventfd cannot be created
+     */
+    DumpEngine(const sdeventplus::Event& event,
+               std::unique_ptr<sbe_chipop::SbeDumpCollector> collector);
+
+    /**
+     * @brief Waits for the running dumps.
+     */
+    ~DumpEngine();
+
+    /**
+     * @brief Starts collecting a dump.
+     *
+     * @param[in] request - The dump to collect
+     * @param[in] completion - Called with the outcome of the dump
+     */
+    void start(DumpRequest request, Completion completion);
+
+    /**
+     * @brief Starts collecting the dump files, without packaging them.
+     *
+     * @param[in] type - Type of the dump, one of the SBE_DUMP_TYPE_* values
+     * @param[in] id - Id of the dump
+     * @param[in] failingUnit - Id of the failing unit
+     * @param[in] path - Directory receiving the dump files
+     * @param[in] deadline - Time allowed for a hardware or hostboot
+     *                       collection, 0 for no limit
+     * @param[in] completion - Called with the outcome of the collection
+     */
+    void collect(uint8_t type, uint32_t id, uint32_t failingUnit,
+                 std::filesystem::path path, std::chrono::seconds deadline,
+                 Completion completion);
+
+    /**
+     * @brief Returns the collector shared by the dumps.
+     */
+    const sbe_chipop::SbeDumpCollector& getCollector() const
+    {
+        return *collector;
+    }
+
+  private:
+    /** @brief Outcome of a dump waiting to be reported */
+    struct Finished
+    {
+        uint64_t job;
+        bool success;
+    };
+
+    /** @brief Collector shared by the dumps */
+    std::unique_ptr<sbe_chipop::SbeDumpCollector> collector;
+
+    /** @brief Signalled by the dump threads when they finish */
+    int eventFd = -1;
+
+    /** @brief Dispatches the completions on the event loop */
+    std::unique_ptr<sdeventplus::source::IO> eventSource;
+
+    /** @brief Threads and completions of the running dumps */
+    std::map<uint64_t, std::pair<std::thread, Completion>> jobs;
+
+    /** @brief Id of the next dump */
+    uint64_t nextJob = 0;
+
+    /** @brief Protects finished */
+    std::mutex mutex;
+
+    /** @brief Dumps finished and not reported yet */
+    std::vector<Finished> finished;
+
+    /**
+     * @brief Collects and packages a dump, on its own thread.
+     *
+     * @param[in] request - The dump to collect
+     *
+     * @return true if the dump was packaged
+     */
+    bool run(const DumpRequest& request);
+
+    /**
+     * @brief Runs a job on its own thread, its outcome is reported from the
+     * event loop.
+     *
+     * @param[in] work - The job, returns true on success
+     * @param[in] completion - Called with the outcome of the job
+     */
+    void startJob(std::function<bool()> work, Completion completion);
+
+    /**
+     * @brief Reports the finished dumps, on the event loop thread.
+     */
+    void dispatch();
+};
+
+} // namespace openpower::dump
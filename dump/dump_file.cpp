@@ -0,0 +1,136 @@
+#include "dump_file.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <cerrno>
+#include <system_error>
+
+namespace openpower::dump
+{
+
+namespace
+{
+
+std::filesystem::path finalPath(const std::filesystem::path& path,
+                                DumpCompression compression)
+{
+    if (compression == DumpCompression::gzip)
+    {
+        return path.string() + ".gz";
+    }
+    return path;
+}
+
+} // namespace
+
+DumpFile::DumpFile(const std::filesystem::path& path,
+                   DumpCompression compression) :
+    path(finalPath(path, compression)),
+    tempPath(this->path.parent_path() /
+             ("." + this->path.filename().string()))
+{
+    if (compression == DumpCompression::gzip)
+    {
+        // The compression runs on the thread collecting the dumps, favour
+        // speed over ratio so it keeps up with the SBE.
+        gzip = std::make_unique<GzipStream>(
+            [this](const uint8_t* data, size_t len) { writeStored(data, len); },
+            Z_BEST_SPEED);
+    }
+
+    fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+              0644);
+    if (fd == -1)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to create " + tempPath.string());
+    }
+}
+
+DumpFile::~DumpFile()
+{
+    if (fd != -1)
+    {
+        close(fd);
+    }
+    if (!committed)
+    {
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+    }
+}
+
+void DumpFile::writeStored(const uint8_t* data, size_t len)
+{
+    while (len > 0)
+    {
+        auto rc = ::write(fd, data, len);
+        if (rc == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(),
+                                    "Failed to write " + tempPath.string());
+        }
+        data += rc;
+        len -= rc;
+        stored += rc;
+    }
+}
+
+void DumpFile::write(const uint8_t* data, size_t len)
+{
+    if (gzip)
+    {
+        gzip->write(data, len);
+    }
+    else
+    {
+        writeStored(data, len);
+    }
+    written += len;
+}
+
+void DumpFile::writeAt(uint64_t offset, const uint8_t* data, size_t len)
+{
+    while (len > 0)
+    {
+        auto rc = pwrite(fd, data, len, offset);
+        if (rc == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(),
+                                    "Failed to write " + tempPath.string());
+        }
+        data += rc;
+        len -= rc;
+        offset += rc;
+    }
+}
+
+void DumpFile::commit()
+{
+    if (gzip)
+    {
+        gzip->finish();
+    }
+
+    auto rc = close(fd);
+    fd = -1;
+    if (rc == -1)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to close " + tempPath.string());
+    }
+    std::filesystem::rename(tempPath, path);
+    committed = true;
+}
+
+} // namespace openpower::dump
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "gzip_stream.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+namespace openpower::dump
+{
+
+/**
+ * @brief Compression applied to the dump data as it is written.
+ */
+enum class DumpCompression
+{
+    none,
+    gzip,
+};
+
+/**
+ * @class DumpFile
+ * @brief A dump file written incrementally as the data arrives.
+ *
+ * The data is written to a hidden temporary file in the same directory,
+ * which is renamed to the final name on commit(). A DumpFile destroyed
+ * without commit() removes the partially written data, so an interrupted
+ * collection never leaves a truncated dump file for packaging.
+ *
+ * With gzip compression the data is compressed by the writing thread into
+ * a single gzip member and ".gz" is appended to the final name.
+ */
+class DumpFile
+{
+  public:
+    DumpFile() = delete;
+    DumpFile(const DumpFile&) = delete;
+    DumpFile& operator=(const DumpFile&) = delete;
+    DumpFile(DumpFile&&) = delete;
+    DumpFile& operator=(DumpFile&&) = delete;
+
+    /**
+     * @brief Creates the temporary file for the dump.
+     *
+     * @param[in] path - Final path of the dump file, without the suffix of
+     *                   the compression
+     * @param[in] compression - Compression applied to the data
+     *
+     * Exceptions: std::system_error if the file cannot be created
+     */
+    explicit DumpFile(const std::filesystem::path& path,
+                      DumpCompression compression = DumpCompression::none);
+
+    /**
+     * @brief Closes the file and removes it unless committed.
+     */
+    ~DumpFile();
+
+    /**
+     * @brief Appends data to the file.
+     *
+     * @param[in] data - Data to write
+     * @param[in] len - Length of the data
+     *
+     * Exceptions: std::system_error on write failure
+     */
+    void write(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Overwrites data already written to an uncompressed file,
+     * without moving the write position.
+     *
+     * @param[in] offset - Offset in the file
+     * @param[in] data - Data to write
+     * @param[in] len - Length of the data
+     *
+     * Exceptions: std::system_error on write failure
+     */
+    void writeAt(uint64_t offset, const uint8_t* data, size_t len);
+
+    /**
+     * @brief Closes the file and moves it to the final path.
+     *
+     * Exceptions: std::system_error on failure
+     */
+    void commit();
+
+    /**
+     * @brief Returns the final path of the dump file.
+     */
+    const std::filesystem::path& getPath() const
+    {
+        return path;
+    }
+
+    /**
+     * @brief Returns the number of bytes of dump data written.
+     */
+    uint64_t size() const
+    {
+        return written;
+    }
+
+    /**
+     * @brief Returns the number of bytes stored in the file.
+     */
+    uint64_t storedSize() const
+    {
+        return stored;
+    }
+
+  private:
+    /** @brief Final path of the dump file */
+    std::filesystem::path path;
+
+    /** @brief Path of the file while it is being written */
+    std::filesystem::path tempPath;
+
+    /** @brief Descriptor of the temporary file */
+    int fd = -1;
+
+    /** @brief Number of bytes of dump data written */
+    uint64_t written = 0;
+
+    /** @brief Number of bytes stored in the file */
+    uint64_t stored = 0;
+
+    /** @brief Compressor, nullptr when the data is not compressed */
+    std::unique_ptr<GzipStream> gzip;
+
+    /**
+     * @brief Writes data to the file as is.
+     */
+    void writeStored(const uint8_t* data, size_t len);
+
+    /** @brief Set once the file is moved to the final path */
+    bool committed = false;
+};
+
+} // namespace openpower::dump
@@ -0,0 +1,234 @@
+#include "dump_header.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace openpower::dump::header
+{
+
+namespace
+{
+
+/**
+ * @class StructWriter
+ * @brief Writes the fields of a structure located at an offset of the
+ * header. Fields not written stay NUL.
+ */
+class StructWriter
+{
+  public:
+    StructWriter(std::vector<uint8_t>& header, size_t base) :
+        header(header), base(base)
+    {}
+
+    /** @brief Text padded with NULs or truncated to the field */
+    void text(const Field& field, const std::string& value)
+    {
+        auto len = std::min(value.size(), field.size);
+        std::memcpy(at(field), value.data(), len);
+    }
+
+    /** @brief Text padded with a character or truncated to the field */
+    void text(const Field& field, const std::string& value, char padding)
+    {
+        std::memset(at(field), padding, field.size);
+        text(field, value);
+    }
+
+    /** @brief Number in big endian byte order */
+    void number(const Field& field, uint64_t value)
+    {
+        putBigEndian(at(field), value, field.size);
+    }
+
+    /**
+     * @brief Pairs of hex digits as bytes, left or right aligned.
+     *
+     * The time stamp digits are written the same way, which gives the BCD
+     * encoding of the time.
+     */
+    void hexBytes(const Field& field, const std::string& digits,
+                  bool leftAlign)
+    {
+        std::vector<uint8_t> values;
+        for (size_t i = 0; i < digits.size(); i += 2)
+        {
+            values.push_back(std::stoul(digits.substr(i, 2), nullptr, 16));
+        }
+        values.resize(std::min(values.size(), field.size));
+
+        auto dest = at(field);
+        if (!leftAlign)
+        {
+            dest += field.size - values.size();
+        }
+        std::copy(values.begin(), values.end(), dest);
+    }
+
+  private:
+    std::vector<uint8_t>& header;
+    size_t base;
+
+    uint8_t* at(const Field& field)
+    {
+        return header.data() + base + field.offset;
+    }
+};
+
+/** @brief Writes the virtual file directory entry */
+void writeFileEntry(std::vector<uint8_t>& header, const std::string& prefix,
+                    const std::string& serial, const std::string& dumpId,
+                    const std::string& timestamp)
+{
+    StructWriter entry(header, 0);
+    entry.text(file_entry::eyeCatcher, "FILE    ");
+    entry.number(file_entry::entrySize, file_entry::size);
+    entry.number(file_entry::entryType, 0x01);
+    entry.number(file_entry::prefixSize, 0x0F);
+
+    auto id = dumpId.substr(0, 8);
+    entry.text(file_entry::fileName,
+               prefix + "." + serial.substr(0, 7) + "." +
+                   std::string(8 - id.size(), '0') + id + "." +
+                   timestamp.substr(0, 14));
+}
+
+/** @brief Writes a section directory entry */
+void writeSection(std::vector<uint8_t>& header, size_t base, uint16_t priority,
+                  uint32_t flags, uint64_t dumpSize, const std::string& name)
+{
+    StructWriter section(header, base);
+    section.text(section_entry::eyeCatcher, "SECTION ");
+    section.number(section_entry::entrySize, section_entry::size);
+    section.number(section_entry::priority, priority);
+    section.number(section_entry::flags, flags);
+    section.number(section_entry::type, 0x02);
+    section.number(section_entry::dumpSize, dumpSize);
+    section.text(section_entry::name, name);
+}
+
+/** @brief Content type of the dump from the first digits of the dump id */
+std::string contentType(const std::string& dumpId)
+{
+    auto prefix = dumpId.substr(0, 2);
+    if (prefix == "20")
+    {
+        // Hostboot dump
+        return "00000200";
+    }
+    if (prefix == "00")
+    {
+        // Hardware dump
+        return "40000000";
+    }
+    if (prefix == "30" || prefix == "40")
+    {
+        // SBE dump
+        return "02000000";
+    }
+    return "00000000";
+}
+
+} // namespace
+
+void putBigEndian(uint8_t* dest, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        dest[size - 1 - i] = (i < sizeof(value))
+                                 ? static_cast<uint8_t>(value >> (8 * i))
+                                 : 0;
+    }
+}
+
+std::string checkTimestamp(const std::string& timestamp)
+{
+    auto digit = [](char c) { return c >= '0' && c <= '9'; };
+    if (timestamp.size() != 14 || !std::ranges::all_of(timestamp, digit))
+    {
+        return "must be 14 digits, yyyymmddhhmmss";
+    }
+    return {};
+}
+
+std::vector<uint8_t> buildOpDumpHeader(const OpDumpHeaderInfo& info)
+{
+    std::vector<uint8_t> header(op_dump::size, 0);
+
+    writeFileEntry(header, "SYSDUMP", info.serial, info.dumpId,
+                   info.timestamp);
+    writeSection(header, op_dump::summarySection, 0x00, 0x00,
+                 plat_summary::size, "DUMP SUMMARY");
+    writeSection(header, op_dump::hardwareSection, 0x02, 0x00, 0,
+                 "HARDWARE DATA");
+    writeSection(header, op_dump::mainstoreSection, 0x02, 0x01, 0,
+                 "HYPERVISOR DATA");
+
+    StructWriter summary(header, op_dump::platSummary);
+    summary.text(plat_summary::eyeCatcher, "SYS DUMP");
+    summary.hexBytes(plat_summary::requestTime, info.timestamp, true);
+    summary.hexBytes(plat_summary::dumpId, info.dumpId.substr(0, 8), false);
+    summary.number(plat_summary::version, 0x0221);
+    summary.number(plat_summary::headerSize, plat_summary::size);
+    summary.text(plat_summary::machineInfo, info.model);
+    summary.text(plat_summary::systemName, info.systemName);
+    summary.text(plat_summary::serialNumber, info.serial);
+    summary.number(plat_summary::creator, 0x01);
+    if (info.eid.size() == 8)
+    {
+        summary.hexBytes(plat_summary::eventLogId, info.eid, true);
+    }
+    summary.number(plat_summary::fileHeaderSize, 0xD0);
+    summary.hexBytes(plat_summary::contentType, contentType(info.dumpId),
+                     true);
+    summary.number(plat_summary::creatorBmc, 0x01);
+
+    return header;
+}
+
+void setOpDumpSizes(std::span<uint8_t> header, uint64_t archiveSize)
+{
+    putBigEndian(header.data() + op_dump::archiveSize.offset, archiveSize,
+                 op_dump::archiveSize.size);
+    putBigEndian(header.data() + op_dump::totalSize.offset,
+                 archiveSize + plat_summary::size, op_dump::totalSize.size);
+}
+
+std::vector<uint8_t> buildBmcDumpHeader(const BmcDumpHeaderInfo& info)
+{
+    std::vector<uint8_t> header(bmc_dump::size, 0);
+    std::string name = info.faultData ? "FLTDUMP" : "BMCDUMP";
+    uint64_t dumpSize = info.archiveSize + bmc_dump::countedSize;
+
+    writeFileEntry(header, name, info.serial, info.dumpId, info.timestamp);
+    writeSection(header, bmc_dump::section, 0x00, 0x01, dumpSize, name);
+
+    StructWriter summary(header, bmc_dump::summary);
+    summary.text(bmc_summary::eyeCatcher,
+                 info.faultData ? "FLT DUMP" : "BMC DUMP");
+    summary.hexBytes(bmc_summary::requestTime, info.timestamp, true);
+    summary.number(bmc_summary::version, 0x0210);
+    summary.number(bmc_summary::headerSize, bmc_summary::size);
+    summary.number(bmc_summary::totalSize, dumpSize);
+    summary.text(bmc_summary::panelFunction, info.model);
+    summary.text(bmc_summary::systemName,
+                 "Server-" + info.model + "-SN" + info.serial);
+    summary.text(bmc_summary::serialNumber, info.serial);
+    if (info.eid.size() == 8)
+    {
+        summary.hexBytes(bmc_summary::plid, info.eid, true);
+    }
+    summary.number(bmc_summary::fileHeaderSize, 0x70);
+    summary.text(bmc_summary::bmcSerialNumber, info.bmcSerial, '0');
+    summary.text(bmc_summary::originatorType, info.originatorType);
+    summary.text(bmc_summary::originatorId, info.originatorId);
+
+    StructWriter entry(header, bmc_dump::entry);
+    entry.number(dump_entry::version, 0x01);
+    entry.number(dump_entry::valid, 0x01);
+    entry.number(dump_entry::count, 0x10);
+
+    return header;
+}
+
+} // namespace openpower::dump::header
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace openpower::dump::header
+{
+
+/**
+ * @struct Field
+ * @brief Position of a field within a header structure.
+ */
+struct Field
+{
+    size_t offset;
+    size_t size;
+
+    constexpr size_t end() const
+    {
+        return offset + size;
+    }
+};
+
+/**
+ * @brief Virtual file directory entry, the first entry of every dump.
+ */
+namespace file_entry
+{
+constexpr Field eyeCatcher{0, 8};
+constexpr Field entrySize{8, 2};
+constexpr Field reserved{10, 10};
+constexpr Field entryType{20, 2};
+constexpr Field prefixSize{22, 2};
+constexpr Field fileName{24, 39};
+constexpr Field terminator{63, 1};
+constexpr size_t size = terminator.end();
+static_assert(size == 64);
+} // namespace file_entry
+
+/**
+ * @brief Section directory entry describing a part of the dump.
+ */
+namespace section_entry
+{
+constexpr Field eyeCatcher{0, 8};
+constexpr Field entrySize{8, 2};
+constexpr Field priority{10, 2};
+constexpr Field reserved{12, 4};
+constexpr Field flags{16, 4};
+constexpr Field type{20, 2};
+constexpr Field reserved2{22, 2};
+constexpr Field dumpSize{24, 8};
+constexpr Field name{32, 16};
+constexpr size_t size = name.end();
+static_assert(size == 48);
+} // namespace section_entry
+
+/**
+ * @brief Dump summary of a BMC or fault data dump.
+ */
+namespace bmc_summary
+{
+constexpr Field eyeCatcher{0, 8};
+constexpr Field requestTime{8, 8};
+constexpr Field dumpId{16, 4};
+constexpr Field version{20, 2};
+constexpr Field headerSize{22, 2};
+constexpr Field totalSize{24, 8};
+constexpr Field panelFunction{32, 32};
+constexpr Field systemName{64, 32};
+constexpr Field serialNumber{96, 7};
+constexpr Field reserved{103, 1};
+constexpr Field plid{104, 4};
+constexpr Field fileHeaderSize{108, 2};
+constexpr Field srcSize{110, 2};
+constexpr Field src{112, 320};
+constexpr Field bmcSerialNumber{432, 12};
+constexpr Field originatorType{444, 4};
+constexpr Field originatorId{448, 32};
+constexpr Field requesterUserId{480, 32};
+constexpr size_t size = requesterUserId.end();
+static_assert(size == 512);
+} // namespace bmc_summary
+
+/**
+ * @brief Dump entry closing the header of a BMC or fault data dump.
+ */
+namespace dump_entry
+{
+constexpr Field version{0, 1};
+constexpr Field valid{1, 1};
+constexpr Field count{2, 2};
+constexpr size_t size = count.end();
+static_assert(size == 4);
+} // namespace dump_entry
+
+/**
+ * @brief Platform system dump header of a system dump.
+ */
+namespace plat_summary
+{
+constexpr Field eyeCatcher{0, 8};
+constexpr Field requestTime{8, 8};
+constexpr Field dumpId{16, 4};
+constexpr Field version{20, 2};
+constexpr Field headerSize{22, 2};
+constexpr Field totalSize{24, 8};
+constexpr Field machineInfo{32, 32};
+constexpr Field systemName{64, 32};
+constexpr Field serialNumber{96, 7};
+constexpr Field creator{103, 1};
+constexpr Field eventLogId{104, 4};
+constexpr Field fileHeaderSize{108, 2};
+constexpr Field contentType{608, 4};
+constexpr Field creatorBmc{656, 1};
+constexpr size_t size = 1024;
+static_assert(creatorBmc.end() <= size);
+} // namespace plat_summary
+
+/**
+ * @brief Offsets of the structures in the header of a system dump.
+ */
+namespace op_dump
+{
+constexpr size_t fileEntry = 0;
+constexpr size_t summarySection = fileEntry + file_entry::size;
+constexpr size_t hardwareSection = summarySection + section_entry::size;
+constexpr size_t mainstoreSection = hardwareSection + section_entry::size;
+constexpr size_t platSummary = mainstoreSection + section_entry::size;
+constexpr size_t size = platSummary + plat_summary::size;
+static_assert(size == 1232);
+
+/** @brief Archive size, filled once the archive is written */
+constexpr Field archiveSize{hardwareSection + section_entry::dumpSize.offset,
+                            section_entry::dumpSize.size};
+
+/** @brief Archive size plus the platform summary, filled the same way */
+constexpr Field totalSize{platSummary + plat_summary::totalSize.offset,
+                          plat_summary::totalSize.size};
+} // namespace op_dump
+
+/**
+ * @brief Offsets of the structures in the header of a BMC dump.
+ */
+namespace bmc_dump
+{
+constexpr size_t fileEntry = 0;
+constexpr size_t section = fileEntry + file_entry::size;
+constexpr size_t summary = section + section_entry::size;
+constexpr size_t entry = summary + bmc_summary::size;
+constexpr size_t size = entry + dump_entry::size;
+static_assert(size == 628);
+
+/** @brief Size of the header counted in the dump sizes */
+constexpr size_t countedSize = bmc_summary::size + dump_entry::size;
+} // namespace bmc_dump
+
+/**
+ * @struct OpDumpHeaderInfo
+ * @brief Values recorded in the header of a system dump.
+ */
+struct OpDumpHeaderInfo
+{
+    /** @brief Dump id, 8 hex digits, the first two give the content */
+    std::string dumpId;
+
+    /** @brief Error log id, 8 hex digits, empty if none */
+    std::string eid;
+
+    /** @brief System serial number, 7 characters */
+    std::string serial;
+
+    /** @brief System model */
+    std::string model;
+
+    /** @brief System name */
+    std::string systemName;
+
+    /** @brief Request time as yyyymmddhhmmss */
+    std::string timestamp;
+};
+
+/**
+ * @struct BmcDumpHeaderInfo
+ * @brief Values recorded in the header of a BMC or fault data dump.
+ */
+struct BmcDumpHeaderInfo
+{
+    /** @brief True for a fault data dump */
+    bool faultData = false;
+
+    /** @brief Dump id, 8 digits */
+    std::string dumpId;
+
+    /** @brief Error log id, 8 hex digits, empty if none */
+    std::string eid;
+
+    /** @brief System serial number, 7 characters */
+    std::string serial;
+
+    /** @brief BMC serial number */
+    std::string bmcSerial;
+
+    /** @brief System model */
+    std::string model;
+
+    /** @brief Request time as yyyymmddhhmmss */
+    std::string timestamp;
+
+    /** @brief Originator type of the dump request, empty if unknown */
+    std::string originatorType;
+
+    /** @brief Originator id of the dump request */
+    std::string originatorId;
+
+    /** @brief Size of the dump archive following the header */
+    uint64_t archiveSize = 0;
+};
+
+/**
+ * @brief Builds the header of a system dump.
+ *
+ * The archive size and total size are left zero, to be filled with
+ * setOpDumpSizes() once the archive is written.
+ *
+ * @param[in] info - Values recorded in the header
+ *
+ * @return The header, op_dump::size bytes
+ */
+std::vector<uint8_t> buildOpDumpHeader(const OpDumpHeaderInfo& info);
+
+/**
+ * @brief Fills the size fields of a system dump header.
+ *
+ * @param[out] header - The op_dump::size bytes of the header
+ * @param[in] archiveSize - Size of the archive following the header
+ */
+void setOpDumpSizes(std::span<uint8_t> header, uint64_t archiveSize);
+
+/**
+ * @brief Builds the header of a BMC or fault data dump.
+ *
+ * @param[in] info - Values recorded in the header
+ *
+ * @return The header, bmc_dump::size bytes
+ */
+std::vector<uint8_t> buildBmcDumpHeader(const BmcDumpHeaderInfo& info);
+
+/**
+ * @brief Checks a dump time given on the command line.
+ *
+ * @param[in] timestamp - The time, as yyyymmddhhmmss
+ *
+ * @return An empty string if valid, else the reason it is not
+ */
+std::string checkTimestamp(const std::string& timestamp);
+
+/**
+ * @brief Writes a value in big endian byte order into a field.
+ *
+ * @param[out] dest - Start of the field
+ * @param[in] value - The value
+ * @param[in] size - Size of the field
+ */
+void putBigEndian(uint8_t* dest, uint64_t value, size_t size);
+
+} // namespace openpower::dump::header
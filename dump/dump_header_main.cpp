@@ -0,0 +1,175 @@
+#include "dump_file.hpp"
+#include "dump_header.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <CLI/Formatter.hpp>
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+
+/** @brief Size of the chunks copied from the payload */
+constexpr size_t copyChunkSize = 256 * 1024;
+
+/**
+ * @brief Appends the payload to the dump file.
+ *
+ * @return Size of the payload
+ */
+uint64_t appendPayload(openpower::dump::DumpFile& dumpFile, int fd,
+                       const std::string& payload)
+{
+    std::vector<uint8_t> buffer(copyChunkSize);
+    uint64_t copied = 0;
+    while (true)
+    {
+        auto rc = read(fd, buffer.data(), buffer.size());
+        if (rc == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (rc == -1)
+        {
+            throw std::system_error(errno, std::generic_category(),
+                                    "Failed to read " + payload);
+        }
+        if (rc == 0)
+        {
+            return copied;
+        }
+        dumpFile.write(buffer.data(), rc);
+        copied += rc;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace openpower::dump;
+    using namespace openpower::dump::header;
+
+    CLI::App app{"Dump Header Application", "dump-header"};
+    app.description(
+        "Writes the dump header of a system, BMC or fault data dump, "
+        "optionally followed by the dump archive.");
+
+    std::string type = "bmc";
+    std::string output;
+    std::string payload;
+    std::optional<uint64_t> size;
+    std::string systemName;
+    OpDumpHeaderInfo opInfo;
+    BmcDumpHeaderInfo bmcInfo;
+
+    app.add_option("--type", type, "Type of the dump")
+        ->check(CLI::IsMember({"system", "bmc", "faultdata"}));
+    app.add_option("--output, -o", output, "File to write")->required();
+    app.add_option("--payload, -p", payload,
+                   "Dump archive to append after the header");
+    app.add_option("--size", size,
+                   "Size of the dump archive, when it is not appended");
+    app.add_option("--id, -i", bmcInfo.dumpId, "ID of the dump")
+        ->required();
+    app.add_option("--eid, -e", bmcInfo.eid,
+                   "Error log ID associated with the dump in hex");
+    app.add_option("--serial, -s", bmcInfo.serial, "System serial number")
+        ->required();
+    app.add_option("--bmc-serial", bmcInfo.bmcSerial, "BMC serial number");
+    app.add_option("--model, -m", bmcInfo.model, "System model");
+    app.add_option("--time, -t", bmcInfo.timestamp,
+                   "Dump request time as yyyymmddhhmmss")
+        ->required()
+        ->check(checkTimestamp, "yyyymmddhhmmss");
+    app.add_option("--name, -n", systemName,
+                   "System name of a system dump, defaults to the host name");
+    app.add_option("--originator-type", bmcInfo.originatorType,
+                   "Originator type of the dump request");
+    app.add_option("--originator-id", bmcInfo.originatorId,
+                   "Originator ID of the dump request");
+
+    try
+    {
+        CLI11_PARSE(app, argc, argv);
+    }
+    catch (const CLI::ParseError& e)
+    {
+        return app.exit(e);
+    }
+
+    try
+    {
+        int fd = -1;
+        uint64_t archiveSize = size.value_or(0);
+        if (!payload.empty())
+        {
+            fd = open(payload.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat st{};
+            if (fd == -1 || fstat(fd, &st) == -1)
+            {
+                throw std::system_error(errno, std::generic_category(),
+                                        "Failed to open " + payload);
+            }
+            archiveSize = st.st_size;
+        }
+
+        std::vector<uint8_t> headerData;
+        if (type == "system")
+        {
+            opInfo.dumpId = bmcInfo.dumpId;
+            opInfo.eid = bmcInfo.eid;
+            opInfo.serial = bmcInfo.serial;
+            opInfo.model = bmcInfo.model;
+            opInfo.timestamp = bmcInfo.timestamp;
+            opInfo.systemName = systemName;
+            if (opInfo.systemName.empty())
+            {
+                char hostname[HOST_NAME_MAX + 1] = {};
+                gethostname(hostname, sizeof(hostname) - 1);
+                opInfo.systemName = hostname;
+            }
+            headerData = buildOpDumpHeader(opInfo);
+            setOpDumpSizes(headerData, archiveSize);
+        }
+        else
+        {
+            bmcInfo.faultData = (type == "faultdata");
+            bmcInfo.archiveSize = archiveSize;
+            headerData = buildBmcDumpHeader(bmcInfo);
+        }
+
+        DumpFile dumpFile(output);
+        dumpFile.write(headerData.data(), headerData.size());
+        if (fd != -1)
+        {
+            auto copied = appendPayload(dumpFile, fd, payload);
+            close(fd);
+            if (copied != archiveSize)
+            {
+                throw std::runtime_error(payload + " changed while copying");
+            }
+        }
+        dumpFile.commit();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to write dump header: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "dump_job_queue.hpp"
+
+#include "sbe_consts.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace openpower::dump
+{
+
+DumpJobQueue::DumpJobQueue(std::map<uint32_t, size_t> typeLimits,
+                           size_t maxRunning) :
+    typeLimits(std::move(typeLimits)),
+    maxRunning(std::max<size_t>(maxRunning, 1))
+{}
+
+void DumpJobQueue::push(DumpJob job)
+{
+    job.sequence = nextSequence++;
+    job.queued = std::chrono::steady_clock::now();
+    jobs.insert(std::move(job));
+}
+
+std::vector<DumpJob> DumpJobQueue::takeRunnable()
+{
+    std::vector<DumpJob> runnable;
+    for (auto it = jobs.begin();
+         it != jobs.end() && totalRunning < maxRunning;)
+    {
+        auto limitIt = typeLimits.find(it->dumpType);
+        size_t limit = (limitIt != typeLimits.end()) ? limitIt->second : 1;
+        auto& running = typeRunning[it->dumpType];
+        if (running >= limit)
+        {
+            ++it;
+            continue;
+        }
+        running++;
+        totalRunning++;
+        runnable.push_back(*it);
+        it = jobs.erase(it);
+    }
+    return runnable;
+}
+
+void DumpJobQueue::finished(uint32_t dumpType)
+{
+    auto& running = typeRunning[dumpType];
+    if (running > 0)
+    {
+        running--;
+        totalRunning--;
+    }
+}
+
+std::vector<DumpJob> DumpJobQueue::queuedJobs() const
+{
+    return {jobs.begin(), jobs.end()};
+}
+
+unsigned DumpJobQueue::priorityOf(uint32_t dumpType, bool hasFailingUnit)
+{
+    using namespace openpower::dump::SBE;
+    switch (dumpType)
+    {
+        case SBE_DUMP_TYPE_HARDWARE:
+            return hasFailingUnit ? 0 : 1;
+        case SBE_DUMP_TYPE_HOSTBOOT:
+            return 2;
+        case SBE_DUMP_TYPE_SBE:
+            return 3;
+        case SBE_DUMP_TYPE_MSBE:
+            return 4;
+        default:
+            return 5;
+    }
+}
+
+} // namespace openpower::dump
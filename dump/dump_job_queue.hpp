@@ -0,0 +1,137 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace openpower::dump
+{
+
+/**
+ * @struct DumpJob
+ * @brief A dump collection waiting for, or holding, a collection slot.
+ */
+struct DumpJob
+{
+    /** @brief Object path of the dump entry */
+    std::string path;
+
+    /** @brief Type of the dump, one of the SBE_DUMP_TYPE_* values */
+    uint32_t dumpType = 0;
+
+    /** @brief Priority of the job, lower values are started first */
+    unsigned priority = 0;
+
+    /** @brief Order of arrival, breaks ties between equal priorities */
+    uint64_t sequence = 0;
+
+    /** @brief Time the job was queued */
+    std::chrono::steady_clock::time_point queued;
+};
+
+/**
+ * @class DumpJobQueue
+ * @brief Orders dump jobs by priority and hands them out within the
+ * concurrency limits of their dump type.
+ *
+ * A job whose type has no free slot does not hold back the jobs behind it,
+ * so a burst of one type of dump cannot delay the other types.
+ */
+class DumpJobQueue
+{
+  public:
+    /**
+     * @brief Creates the queue.
+     *
+     * @param[in] typeLimits - Maximum running jobs for each dump type, types
+     *                         not listed run one job at a time
+     * @param[in] maxRunning - Maximum running jobs over all the types
+     */
+    DumpJobQueue(std::map<uint32_t, size_t> typeLimits, size_t maxRunning);
+
+    /**
+     * @brief Queues a job, stamping its arrival order and time.
+     *
+     * @param[in] job - The job
+     */
+    void push(DumpJob job);
+
+    /**
+     * @brief Removes the jobs that can start now from the queue, highest
+     * priority first, and counts them as running.
+     *
+     * @return The jobs to start
+     */
+    std::vector<DumpJob> takeRunnable();
+
+    /**
+     * @brief Releases the slot of a running job.
+     *
+     * @param[in] dumpType - Type of the finished job
+     */
+    void finished(uint32_t dumpType);
+
+    /** @brief Returns the queued jobs, highest priority first */
+    std::vector<DumpJob> queuedJobs() const;
+
+    /** @brief Returns the number of queued jobs */
+    size_t depth() const
+    {
+        return jobs.size();
+    }
+
+    /** @brief Returns the number of running jobs */
+    size_t running() const
+    {
+        return totalRunning;
+    }
+
+    /**
+     * @brief Priority of a dump, a hardware dump for a failing unit first
+     * and the speculative SBE dumps last.
+     *
+     * @param[in] dumpType - Type of the dump
+     * @param[in] hasFailingUnit - Whether a failing unit was reported
+     *
+     * @return The priority, lower values are started first
+     */
+    static unsigned priorityOf(uint32_t dumpType, bool hasFailingUnit);
+
+  private:
+    /** @brief Orders the jobs by priority, then by arrival */
+    struct JobOrder
+    {
+        bool operator()(const DumpJob& a, const DumpJob& b) const
+        {
+            if (a.priority != b.priority)
+            {
+                return a.priority < b.priority;
+            }
+            return a.sequence < b.sequence;
+        }
+    };
+
+    /** @brief Queued jobs */
+    std::set<DumpJob, JobOrder> jobs;
+
+    /** @brief Maximum running jobs for each dump type */
+    std::map<uint32_t, size_t> typeLimits;
+
+    /** @brief Running jobs for each dump type */
+    std::map<uint32_t, size_t> typeRunning;
+
+    /** @brief Maximum running jobs over all the types */
+    size_t maxRunning;
+
+    /** @brief Running jobs over all the types */
+    size_t totalRunning = 0;
+
+    /** @brief Arrival order of the next job */
+    uint64_t nextSequence = 0;
+};
+
+} // namespace openpower::dump
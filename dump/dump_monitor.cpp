@@ -4,16 +4,186 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <cerrno>
 #include <regex>
+#include <tuple>
+#include <vector>
 
 namespace openpower::dump
 {
 
-constexpr auto dumpOutPath = "/var/lib/phosphor-debug-collector/opdump";
 constexpr auto dumpStatusFailed =
     "xyz.openbmc_project.Common.Progress.OperationStatus.Failed";
 
-void DumpMonitor::executeCollectionScript(const sdbusplus::object_path& path,
+const sdbusplus::vtable::vtable_t DumpMonitor::vtable[] = {
+    sdbusplus::vtable::start(),
+    sdbusplus::vtable::property("QueueDepth", "u", getStatusProperty,
+                                sdbusplus::vtable::property_::emits_change),
+    sdbusplus::vtable::property("RunningJobs", "u", getStatusProperty,
+                                sdbusplus::vtable::property_::emits_change),
+    sdbusplus::vtable::property("LastWaitTime", "t", getStatusProperty,
+                                sdbusplus::vtable::property_::emits_change),
+    sdbusplus::vtable::property(
+        "QueuedJobs", "a(sut)", getStatusProperty,
+        sdbusplus::vtable::property_::emits_invalidation),
+    sdbusplus::vtable::end()};
+
+int DumpMonitor::getStatusProperty(sd_bus*, const char*, const char*,
+                                   const char* property, sd_bus_message* reply,
+                                   void* context, sd_bus_error*)
+{
+    auto monitor = static_cast<DumpMonitor*>(context);
+    std::string name{property};
+    try
+    {
+        sdbusplus::message_t msg{reply};
+        if (name == "QueueDepth")
+        {
+            msg.append(static_cast<uint32_t>(monitor->jobQueue.depth()));
+        }
+        else if (name == "RunningJobs")
+        {
+            msg.append(static_cast<uint32_t>(monitor->jobQueue.running()));
+        }
+        else if (name == "LastWaitTime")
+        {
+            msg.append(static_cast<uint64_t>(monitor->lastWaitTime.count()));
+        }
+        else
+        {
+            // Entry path, dump type and time spent in the queue in ms
+            using namespace std::chrono;
+            auto now = steady_clock::now();
+            std::vector<std::tuple<std::string, uint32_t, uint64_t>> jobs;
+            for (const auto& job : monitor->jobQueue.queuedJobs())
+            {
+                auto waited = duration_cast<milliseconds>(now - job.queued);
+                jobs.emplace_back(job.path, job.dumpType, waited.count());
+            }
+            msg.append(jobs);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to get property {PROPERTY} {ERROR}", "PROPERTY",
+                   name, "ERROR", e);
+        return -EINVAL;
+    }
+    return 1;
+}
+
+void DumpMonitor::queueDumpCollection(const sdbusplus::object_path& path,
+                                      const PropertyMap& properties)
+{
+    if (queuedProperties.contains(path))
+    {
+        lg2::info("Dump collection already queued {PATH}", "PATH", path);
+        return;
+    }
+
+    uint32_t dumpId = std::strtoul(path.filename().c_str(), nullptr, 16);
+    DumpJob job;
+    job.path = path;
+    job.dumpType = getDumpTypeFromId(dumpId);
+    job.priority = DumpJobQueue::priorityOf(
+        job.dumpType, properties.contains("FailingUnitId"));
+
+    lg2::info("Queued dump collection {PATH} {PRIORITY}", "PATH", path,
+              "PRIORITY", job.priority);
+    queuedProperties[path] = properties;
+    jobQueue.push(std::move(job));
+    scheduleDumpCollections();
+}
+
+void DumpMonitor::scheduleDumpCollections()
+{
+    using namespace std::chrono;
+    bool started = false;
+    bool retry = true;
+    while (retry)
+    {
+        // A collection failing to start frees its slot for the next job
+        retry = false;
+        for (auto& job : jobQueue.takeRunnable())
+        {
+            auto node = queuedProperties.extract(job.path);
+            lastWaitTime = duration_cast<milliseconds>(steady_clock::now() -
+                                                       job.queued);
+            lg2::info("Starting dump collection {PATH} after {WAIT_MS} ms",
+                      "PATH", job.path, "WAIT_MS", lastWaitTime.count());
+            bool collecting =
+                engine ? startDumpEngine(job.path, job.dumpType, node.mapped())
+                       : executeCollectionScript(job.path, job.dumpType,
+                                                 node.mapped());
+            if (collecting)
+            {
+                started = true;
+            }
+            else
+            {
+                jobQueue.finished(job.dumpType);
+                retry = true;
+            }
+        }
+    }
+
+    status.property_changed("QueueDepth");
+    status.property_changed("RunningJobs");
+    status.property_changed("QueuedJobs");
+    if (started)
+    {
+        status.property_changed("LastWaitTime");
+    }
+}
+
+bool DumpMonitor::startDumpEngine(const sdbusplus::object_path& path,
+                                  uint32_t dumpType,
+                                  const PropertyMap& properties)
+{
+    std::regex idFormat("^[a-fA-F0-9]{8}$");
+    DumpRequest request;
+    request.path = path;
+    request.dumpId = path.filename();
+    if (!std::regex_match(request.dumpId, idFormat))
+    {
+        lg2::error("Failed to extract dump id from path {PATH}", "PATH", path);
+        updateProgressStatus(path, dumpStatusFailed);
+        return false;
+    }
+    request.dumpType = dumpType;
+    request.outputDir = dumpDir / request.dumpId;
+    request.deadline = collectionDeadline;
+
+    auto errorLogIdIt = properties.find("ErrorLogId");
+    if (errorLogIdIt != properties.end())
+    {
+        request.eid = std::get<uint32_t>(errorLogIdIt->second);
+    }
+
+    auto failingUnitIdIt = properties.find("FailingUnitId");
+    if (failingUnitIdIt != properties.end())
+    {
+        request.failingUnit = std::get<uint32_t>(failingUnitIdIt->second);
+    }
+
+    try
+    {
+        engine->start(std::move(request), [this, path, dumpType](bool success) {
+            collectionFinished(path, dumpType, success);
+        });
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to start dump collection {PATH}, {ERROR}", "PATH",
+                   path, "ERROR", e);
+        updateProgressStatus(path, dumpStatusFailed);
+        return false;
+    }
+    return true;
+}
+
+bool DumpMonitor::executeCollectionScript(const sdbusplus::object_path& path,
+                                          uint32_t dumpType,
                                           const PropertyMap& properties)
 {
     std::vector<std::string> args = {"opdreport"};
@@ -23,13 +193,10 @@ void DumpMonitor::executeCollectionScript(const sdbusplus::object_path& path,
     {
         lg2::error("Failed to extract dump id from path {PATH}", "PATH", path);
         updateProgressStatus(path, dumpStatusFailed);
-        return;
+        return false;
     }
 
-    uint32_t dumpId = std::strtoul(dumpIdStr.c_str(), nullptr, 16);
-    int dumpType = getDumpTypeFromId(dumpId);
-    std::filesystem::path dumpPath =
-        std::filesystem::path(dumpOutPath) / dumpIdStr;
+    auto dumpPath = dumpDir / dumpIdStr;
 
     // Add type, ID, and dump path to args
     args.push_back("-t");
@@ -56,6 +223,12 @@ void DumpMonitor::executeCollectionScript(const sdbusplus::object_path& path,
         args.push_back(std::to_string(failingUnitId));
     }
 
+    if (collectionDeadline.count() > 0)
+    {
+        args.push_back("-D");
+        args.push_back(std::to_string(collectionDeadline.count()));
+    }
+
     std::vector<char*> argv;
     for (auto& arg : args)
     {
@@ -66,36 +239,82 @@ void DumpMonitor::executeCollectionScript(const sdbusplus::object_path& path,
     pid_t pid = fork();
     if (pid == -1)
     {
-        lg2::error("Failed to fork, cannot collect dump, {ERRRNO}", "ERRNO",
+        lg2::error("Failed to fork, cannot collect dump, {ERRNO}", "ERRNO",
                    errno);
         updateProgressStatus(path, dumpStatusFailed);
-        exit(EXIT_FAILURE); // Exit explicitly with failure status
+        return false;
     }
     else if (pid == 0)
     {
-        // Child process
+        // Child process, restore the signal mask of the monitor
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigprocmask(SIG_SETMASK, &mask, nullptr);
         execvp("opdreport", argv.data());
-        perror("execvp");   // execvp only returns on error
+        perror("execvp"); // execvp only returns on error
+        // The bus connection belongs to the parent, which marks the dump
+        // failed when it sees this exit
+        _exit(EXIT_FAILURE);
+    }
+
+    // Parent process, the exit is reported by the event loop
+    lg2::info("Started dump collection {PID} {PATH}", "PID", pid, "PATH", path);
+    try
+    {
+        collections[pid] = std::make_unique<sdeventplus::source::Child>(
+            event, pid, WEXITED,
+            [this, path, dumpType](sdeventplus::source::Child&,
+                                   const siginfo_t* info) {
+                collectionExited(path, dumpType, info);
+            });
+    }
+    catch (const std::exception& e)
+    {
+        // Without a child source the exit would never be seen
+        lg2::error("Failed to watch dump collection {PID}, {ERROR}", "PID",
+                   pid, "ERROR", e);
+        waitpid(pid, nullptr, 0);
         updateProgressStatus(path, dumpStatusFailed);
-        exit(EXIT_FAILURE); // Exit explicitly with failure status
+        return false;
     }
-    else
+    return true;
+}
+
+void DumpMonitor::collectionExited(const sdbusplus::object_path& path,
+                                   uint32_t dumpType, const siginfo_t* info)
+{
+    pid_t pid = info->si_pid;
+    if (info->si_code != CLD_EXITED)
     {
-        // Parent process: wait for the child to terminate
-        int status;
-        waitpid(pid, &status, 0);
-        if (WIFEXITED(status))
-        {
-            int exit_status = WEXITSTATUS(status);
+        lg2::error("Dump collection {PID} terminated by signal {SIGNAL}",
+                   "PID", pid, "SIGNAL", info->si_status);
+    }
+    else if (info->si_status != 0)
+    {
+        lg2::error("Dump collection {PID} failed {EXIT_STATUS}", "PID", pid,
+                   "EXIT_STATUS", info->si_status);
+    }
 
-            if (exit_status != 0)
-            {
-                // Handle failure
-                lg2::error("Dump failed updating status {PATH}", "PATH", path);
-                updateProgressStatus(path, dumpStatusFailed);
-            }
-        }
+    // sd-event defers freeing the source until its dispatch returns
+    collections.erase(pid);
+    collectionFinished(path, dumpType,
+                       info->si_code == CLD_EXITED && info->si_status == 0);
+}
+
+void DumpMonitor::collectionFinished(const sdbusplus::object_path& path,
+                                     uint32_t dumpType, bool success)
+{
+    if (success)
+    {
+        lg2::info("Dump collection completed {PATH}", "PATH", path);
+    }
+    else
+    {
+        lg2::error("Dump failed updating status {PATH}", "PATH", path);
+        updateProgressStatus(path, dumpStatusFailed);
     }
+    jobQueue.finished(dumpType);
+    scheduleDumpCollections();
 }
 
 void DumpMonitor::handleDBusSignal(sdbusplus::message_t& msg)
@@ -127,7 +346,6 @@ void DumpMonitor::handleDBusSignal(sdbusplus::message_t& msg)
 void DumpMonitor::updateProgressStatus(const std::string& path,
                                        const std::string& status)
 {
-    auto bus = sdbusplus::bus::new_default();
     const std::string interfaceName = "xyz.openbmc_project.Common.Progress";
     const std::string propertyName = "Status";
     const std::string serviceName = "xyz.openbmc_project.Dump.Manager";
@@ -156,12 +374,11 @@ void DumpMonitor::startMpReboot(const sdbusplus::object_path& objectPath)
 
     try
     {
-        auto b = sdbusplus::bus::new_default();
-        auto method = b.new_method_call(systemdService, systemdObjPath,
-                                        systemdInterface, "StartUnit");
+        auto method = bus.new_method_call(systemdService, systemdObjPath,
+                                          systemdInterface, "StartUnit");
         method.append(diagModeTarget); // unit to activate
         method.append("replace");
-        b.call_noreply(method);
+        bus.call_noreply(method);
     }
     catch (const sdbusplus::exception_t& e)
     {
@@ -193,7 +410,7 @@ void DumpMonitor::initiateDumpCollection(const std::string& path,
     }
     else
     {
-        executeCollectionScript(path, properties);
+        queueDumpCollection(path, properties);
     }
 }
 
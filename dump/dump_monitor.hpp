@@ -1,18 +1,29 @@
 #pragma once
 
+#include "dump_engine.hpp"
+#include "dump_job_queue.hpp"
 #include "dump_utils.hpp"
 #include "sbe_consts.hpp"
 
+#include <signal.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/server/interface.hpp>
+#include <sdbusplus/vtable.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/child.hpp>
 #include <xyz/openbmc_project/Common/Progress/common.hpp>
 #include <xyz/openbmc_project/Dump/Entry/System/common.hpp>
 
+#include <chrono>
+#include <filesystem>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <string>
 #include <variant>
 
@@ -22,6 +33,14 @@ namespace openpower::dump
 using PropertyMap = std::map<std::string, std::variant<uint32_t, std::string>>;
 using InterfaceMap = std::map<std::string, PropertyMap>;
 
+/* @brief Bus name, object and interface exporting the job queue status */
+constexpr auto monitorBusName = "org.open_power.Dump.Monitor";
+constexpr auto monitorObjectPath = "/org/open_power/dump/monitor";
+constexpr auto monitorInterface = "org.open_power.Dump.Monitor";
+
+/* @brief Directory of the dump manager receiving the packaged dumps */
+constexpr auto dumpOutPath = "/var/lib/phosphor-debug-collector/opdump";
+
 /**
  * @class DumpMonitor
  * @brief Monitors DBus signals for dump creation and handles them.
@@ -32,29 +51,74 @@ class DumpMonitor
     /**
      * @brief Constructor for DumpMonitor.
      * Initializes the DBus connection and signal match for monitoring dump
-     * creation.
+     * creation, and attaches the connection to the event loop which also
+     * reaps the collection processes. SIGCHLD must be blocked before the
+     * monitor is created.
+     *
+     * @param[in] jobQueue - Queue ordering the dump collections
+     * @param[in] collector - Collector of the in-process engine, or null to
+     *                        collect the dumps with the opdreport script
      */
-    DumpMonitor() :
-        bus(sdbusplus::bus::new_default()),
+    DumpMonitor(DumpJobQueue jobQueue,
+                std::unique_ptr<sbe_chipop::SbeDumpCollector> collector) :
+        event(sdeventplus::Event::get_default()),
+        bus(util::getBus()),
         match(bus,
               sdbusplus::match_rules::interfacesAdded(
                   "/xyz/openbmc_project/dump") +
                   sdbusplus::match_rules::sender(
                       "xyz.openbmc_project.Dump.Manager"),
-              [this](sdbusplus::message_t& msg) { handleDBusSignal(msg); })
-    {}
+              [this](sdbusplus::message_t& msg) { handleDBusSignal(msg); }),
+        jobQueue(std::move(jobQueue)),
+        status(bus, monitorObjectPath, monitorInterface, vtable, this)
+    {
+        bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
+        bus.request_name(monitorBusName);
+        if (collector)
+        {
+            engine = std::make_unique<DumpEngine>(event, std::move(collector));
+        }
+    }
 
     /**
-     * @brief Runs the monitor to continuously listen for DBus signals.
+     * @brief Runs the event loop to continuously listen for DBus signals
+     *        and collection process exits.
+     *
+     * @return The exit code of the event loop
+     */
+    int run()
+    {
+        return event.loop();
+    }
+
+    /**
+     * @brief Sets the directory receiving the packaged dumps, each dump in
+     *        the subdirectory named after its id.
+     *
+     * @param[in] dir - The directory, dumpOutPath by default
      */
-    void run()
+    void setDumpDir(const std::filesystem::path& dir)
     {
-        bus.process_loop();
+        dumpDir = dir;
+    }
+
+    /**
+     * @brief Sets the time allowed for each hardware or hostboot dump
+     *        collection, the chips not done in time are abandoned.
+     *
+     * @param[in] deadline - The time allowed, 0 for no limit
+     */
+    void setCollectionDeadline(std::chrono::seconds deadline)
+    {
+        collectionDeadline = deadline;
     }
 
   private:
-    /* @brief sdbusplus handler for a bus to use */
-    sdbusplus::bus_t bus;
+    /* @brief Event loop dispatching the bus and the child sources */
+    sdeventplus::Event event;
+
+    /* @brief Connection of the event loop thread */
+    sdbusplus::bus_t& bus;
 
     /* @brief Monitores dump interfaces */
     const std::vector<std::string> monitoredInterfaces = {
@@ -64,6 +128,41 @@ class DumpMonitor
     /* @brief InterfaceAdded match */
     sdbusplus::match match;
 
+    /* @brief Child sources of the running collections, keyed by pid */
+    std::map<pid_t, std::unique_ptr<sdeventplus::source::Child>> collections;
+
+    /* @brief Collections waiting for a slot */
+    DumpJobQueue jobQueue;
+
+    /* @brief Properties of the queued dump entries, keyed by path */
+    std::map<std::string, PropertyMap> queuedProperties;
+
+    /* @brief Time the last started collection spent in the queue */
+    std::chrono::milliseconds lastWaitTime{0};
+
+    /* @brief Properties exported on monitorInterface */
+    static const sdbusplus::vtable::vtable_t vtable[];
+
+    /* @brief Job queue status object */
+    sdbusplus::server::interface_t status;
+
+    /* @brief In-process collection engine, null to run opdreport */
+    std::unique_ptr<DumpEngine> engine;
+
+    /* @brief Directory receiving the packaged dumps */
+    std::filesystem::path dumpDir = dumpOutPath;
+
+    /* @brief Time allowed for a hardware or hostboot collection */
+    std::chrono::seconds collectionDeadline{0};
+
+    /**
+     * @brief sd-bus getter of the job queue status properties.
+     */
+    static int getStatusProperty(sd_bus* bus, const char* path,
+                                 const char* interface, const char* property,
+                                 sd_bus_message* reply, void* context,
+                                 sd_bus_error* error);
+
     /**
      * @brief Handles the received DBus signal for dump creation.
      * @param[in] msg - The DBus message received.
@@ -93,13 +192,60 @@ class DumpMonitor
     }
 
     /**
-     * @brief Executes the script to collect the dump.
+     * @brief Queues the collection of a dump by priority.
+     * @param[in] path - The object path of the dump entry.
+     * @param[in] properties - The properties of the dump entry.
+     */
+    void queueDumpCollection(const sdbusplus::object_path& path,
+                             const PropertyMap& properties);
+
+    /**
+     * @brief Starts the queued collections which have a free slot.
+     */
+    void scheduleDumpCollections();
+
+    /**
+     * @brief Starts collecting the dump in the monitor. The outcome is
+     *        handled by collectionFinished from the event loop.
      * @param[in] path - The object path of the dump entry.
+     * @param[in] dumpType - The type of the dump.
      * @param[in] properties - The properties of the dump entry.
+     * @return True if the collection was started.
      */
-    void executeCollectionScript(const sdbusplus::object_path& path,
+    bool startDumpEngine(const sdbusplus::object_path& path,
+                         uint32_t dumpType, const PropertyMap& properties);
+
+    /**
+     * @brief Starts the script to collect the dump. The exit of the script
+     *        is handled by collectionExited from the event loop.
+     * @param[in] path - The object path of the dump entry.
+     * @param[in] dumpType - The type of the dump.
+     * @param[in] properties - The properties of the dump entry.
+     * @return True if the script was started.
+     */
+    bool executeCollectionScript(const sdbusplus::object_path& path,
+                                 uint32_t dumpType,
                                  const PropertyMap& properties);
 
+    /**
+     * @brief Handles the exit of a collection script.
+     * @param[in] path - The object path of the dump entry.
+     * @param[in] dumpType - The type of the dump.
+     * @param[in] info - The exit information of the script.
+     */
+    void collectionExited(const sdbusplus::object_path& path,
+                          uint32_t dumpType, const siginfo_t* info);
+
+    /**
+     * @brief Releases the slot of a finished collection and marks the
+     *        dump entry failed if needed.
+     * @param[in] path - The object path of the dump entry.
+     * @param[in] dumpType - The type of the dump.
+     * @param[in] success - Whether the dump was collected.
+     */
+    void collectionFinished(const sdbusplus::object_path& path,
+                            uint32_t dumpType, bool success);
+
     /**
      * @brief Updates the progress status of the dump.
      * @param[in] path - The object path of the dump entry.
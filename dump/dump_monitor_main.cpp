@@ -1,15 +1,99 @@
+#include "dump_job_queue.hpp"
 #include "dump_monitor.hpp"
+#include "sbe_consts.hpp"
 
+#include <signal.h>
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <CLI/Formatter.hpp>
+#include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/bus/match.hpp>
 
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
 #include <exception>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
 #include <variant>
 
-int main()
+int main(int argc, char** argv)
 {
-    openpower::dump::DumpMonitor monitor;
-    monitor.run();
-    return 0;
+    using namespace openpower::dump;
+    using namespace openpower::dump::SBE;
+
+    CLI::App app{"OpenPOWER Dump Monitor", "openpower-dump-monitor"};
+
+    size_t maxJobs = 1;
+    size_t hardwareJobs = 1;
+    size_t hostbootJobs = 1;
+    size_t sbeJobs = 1;
+    size_t msbeJobs = 1;
+    bool inProcessCollector = false;
+    std::string dumpDir = dumpOutPath;
+    unsigned deadline = 0;
+
+    // Nothing keeps collections of different types off the same chips, so
+    // they run one at a time unless asked otherwise
+    app.add_option("--max-jobs", maxJobs,
+                   "Maximum dump collections running at once, more than one "
+                   "lets collections reach the same chips at the same time")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--hardware-jobs", hardwareJobs,
+                   "Maximum hardware dump collections running at once")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--hostboot-jobs", hostbootJobs,
+                   "Maximum hostboot dump collections running at once")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--sbe-jobs", sbeJobs,
+                   "Maximum SBE dump collections running at once")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--msbe-jobs", msbeJobs,
+                   "Maximum memory SBE dump collections running at once")
+        ->check(CLI::PositiveNumber);
+
+    app.add_flag("--in-process-collector", inProcessCollector,
+                 "Collect the dumps in the monitor instead of with the "
+                 "opdreport script, not to be used along with the dump "
+                 "collect daemon");
+
+    app.add_option("--dump-dir", dumpDir,
+                   "Directory of the dump manager receiving the dumps");
+
+    app.add_option("--deadline", deadline,
+                   "Seconds allowed for each hardware or hostboot dump "
+                   "collection, 0 for no limit");
+
+    CLI11_PARSE(app, argc, argv);
+
+    // Collection processes are reaped through child event sources, which
+    // need SIGCHLD blocked before any thread is started.
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    if (sigprocmask(SIG_BLOCK, &mask, nullptr) == -1)
+    {
+        lg2::error("Failed to block SIGCHLD, {ERRNO}", "ERRNO", errno);
+        return EXIT_FAILURE;
+    }
+
+    DumpJobQueue jobQueue({{SBE_DUMP_TYPE_HARDWARE, hardwareJobs},
+                           {SBE_DUMP_TYPE_HOSTBOOT, hostbootJobs},
+                           {SBE_DUMP_TYPE_SBE, sbeJobs},
+                           {SBE_DUMP_TYPE_MSBE, msbeJobs}},
+                          maxJobs);
+    std::unique_ptr<sbe_chipop::SbeDumpCollector> collector;
+    if (inProcessCollector)
+    {
+        collector = std::make_unique<sbe_chipop::SbeDumpCollector>();
+    }
+    DumpMonitor monitor(std::move(jobQueue), std::move(collector));
+    monitor.setDumpDir(dumpDir);
+    monitor.setCollectionDeadline(std::chrono::seconds(deadline));
+    return monitor.run();
 }
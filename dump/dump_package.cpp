@@ -0,0 +1,248 @@
+#include "dump_package.hpp"
+
+#include "dump_file.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <system_error>
+
+namespace openpower::dump::package
+{
+
+namespace
+{
+
+/** @brief Size of a tar block */
+constexpr size_t tarBlockSize = 512;
+
+/** @brief Size of a tar record, archives are padded to it like GNU tar */
+constexpr size_t tarRecordSize = 20 * tarBlockSize;
+
+/** @brief Size of the chunks copied from the archived files */
+constexpr size_t copyChunkSize = 256 * 1024;
+
+/** @brief Largest file size representable in a ustar header */
+constexpr uint64_t tarMaxFileSize = 077777777777ULL;
+
+/** @brief Offsets of the ustar header fields */
+constexpr size_t nameOffset = 0;
+constexpr size_t modeOffset = 100;
+constexpr size_t uidOffset = 108;
+constexpr size_t gidOffset = 116;
+constexpr size_t sizeOffset = 124;
+constexpr size_t mtimeOffset = 136;
+constexpr size_t checksumOffset = 148;
+constexpr size_t typeflagOffset = 156;
+constexpr size_t magicOffset = 257;
+constexpr size_t versionOffset = 263;
+
+/** @brief Writes a NUL terminated octal number filling the field */
+void putOctal(uint8_t* field, size_t size, uint64_t value)
+{
+    std::snprintf(reinterpret_cast<char*>(field), size, "%0*llo",
+                  static_cast<int>(size - 1),
+                  static_cast<unsigned long long>(value));
+}
+
+/** @brief Directory containing the dump files of the chips */
+constexpr auto platDumpDir = "plat_dump";
+
+/** @brief Dump content description created by gendumpinfo */
+constexpr auto dumpInfoFile = "info.yaml";
+
+/** @brief Reports of the collection archived along with the chip dumps,
+ * when the collection wrote them */
+constexpr std::array collectionReports = {"manifest.json", "timing.json",
+                                          "trace.json"};
+
+/**
+ * @brief Returns the SBE dump files to archive, sorted by name like the
+ * shell glob plat_dump/\*Sbe\*.
+ */
+std::vector<std::string> getSbeDumpFiles(const std::filesystem::path& dir)
+{
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::directory_iterator(dir))
+    {
+        auto name = entry.path().filename().string();
+        if (name.starts_with(".") || name.find("Sbe") == std::string::npos)
+        {
+            continue;
+        }
+        files.push_back(name);
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+} // namespace
+
+void TarWriter::write(const uint8_t* data, size_t len)
+{
+    out.write(data, len);
+    written += len;
+}
+
+void TarWriter::pad(size_t multiple)
+{
+    static const std::vector<uint8_t> zeros(tarRecordSize, 0);
+    auto remainder = written % multiple;
+    if (remainder != 0)
+    {
+        write(zeros.data(), multiple - remainder);
+    }
+}
+
+void TarWriter::addFile(const std::filesystem::path& file,
+                        const std::string& name)
+{
+    if (name.size() > 100)
+    {
+        throw std::invalid_argument("Entry name too long: " + name);
+    }
+
+    int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to open " + file.string());
+    }
+    struct stat st{};
+    if (fstat(fd, &st) == -1)
+    {
+        auto err = errno;
+        close(fd);
+        throw std::system_error(err, std::generic_category(),
+                                "Failed to stat " + file.string());
+    }
+    if (static_cast<uint64_t>(st.st_size) > tarMaxFileSize)
+    {
+        close(fd);
+        throw std::invalid_argument("File too large: " + file.string());
+    }
+
+    uint8_t header[tarBlockSize] = {};
+    std::memcpy(header + nameOffset, name.data(), name.size());
+    putOctal(header + modeOffset, 8, st.st_mode & 07777);
+    putOctal(header + uidOffset, 8, st.st_uid);
+    putOctal(header + gidOffset, 8, st.st_gid);
+    putOctal(header + sizeOffset, 12, st.st_size);
+    putOctal(header + mtimeOffset, 12, st.st_mtime);
+    header[typeflagOffset] = '0';
+    std::memcpy(header + magicOffset, "ustar", 6);
+    std::memcpy(header + versionOffset, "00", 2);
+
+    // The checksum is computed with its own field set to spaces
+    std::memset(header + checksumOffset, ' ', 8);
+    unsigned checksum = 0;
+    for (auto byte : header)
+    {
+        checksum += byte;
+    }
+    putOctal(header + checksumOffset, 7, checksum);
+    write(header, sizeof(header));
+
+    buffer.resize(copyChunkSize);
+    uint64_t remaining = st.st_size;
+    while (remaining > 0)
+    {
+        auto rc = read(fd, buffer.data(),
+                       std::min<uint64_t>(buffer.size(), remaining));
+        if (rc == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (rc <= 0)
+        {
+            auto err = (rc == 0) ? EIO : errno;
+            close(fd);
+            throw std::system_error(err, std::generic_category(),
+                                    "Failed to read " + file.string());
+        }
+        write(buffer.data(), rc);
+        remaining -= rc;
+    }
+    close(fd);
+
+    pad(tarBlockSize);
+}
+
+void TarWriter::finish()
+{
+    // End of archive is two zero blocks, then the record is completed
+    static const std::vector<uint8_t> zeros(2 * tarBlockSize, 0);
+    write(zeros.data(), zeros.size());
+    pad(tarRecordSize);
+    out.finish();
+}
+
+uint64_t packageDump(const PackageRequest& request)
+{
+    auto platDumpPath = request.contentDir / platDumpDir;
+    auto sbeFiles = getSbeDumpFiles(platDumpPath);
+    if (sbeFiles.empty())
+    {
+        throw std::runtime_error("No dump files in " + platDumpPath.string());
+    }
+
+    DumpFile archive(request.output);
+
+    auto headerData = header::buildOpDumpHeader(request.header);
+    archive.write(headerData.data(), headerData.size());
+
+    uint64_t archiveSize = 0;
+    GzipStream gzip(
+        [&archive, &archiveSize](const uint8_t* data, size_t len) {
+            archive.write(data, len);
+            archiveSize += len;
+        },
+        Z_DEFAULT_COMPRESSION);
+
+    TarWriter tar(gzip);
+    for (const auto& file : sbeFiles)
+    {
+        tar.addFile(platDumpPath / file,
+                    std::string(platDumpDir) + "/" + file);
+    }
+    for (const auto* report : collectionReports)
+    {
+        if (std::filesystem::exists(platDumpPath / report))
+        {
+            tar.addFile(platDumpPath / report,
+                        std::string(platDumpDir) + "/" + report);
+        }
+    }
+    tar.addFile(request.contentDir / dumpInfoFile, dumpInfoFile);
+    tar.finish();
+
+    if (request.maxSize && archiveSize > *request.maxSize)
+    {
+        // The partial archive is removed with the temporary file
+        throw ArchiveTooLarge(
+            std::format("Archive size {} exceeds the limit {}", archiveSize,
+                        *request.maxSize));
+    }
+
+    // Fill the size fields in place, the rest of the header is unchanged
+    header::setOpDumpSizes(headerData, archiveSize);
+    for (const auto& field :
+         {header::op_dump::archiveSize, header::op_dump::totalSize})
+    {
+        archive.writeAt(field.offset, headerData.data() + field.offset,
+                        field.size);
+    }
+
+    archive.commit();
+    return archiveSize;
+}
+
+} // namespace openpower::dump::package
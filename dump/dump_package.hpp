@@ -0,0 +1,121 @@
+#pragma once
+
+#include "dump_header.hpp"
+#include "gzip_stream.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace openpower::dump::package
+{
+
+/**
+ * @class ArchiveTooLarge
+ * @brief Raised when the archive exceeds the allowed size.
+ */
+class ArchiveTooLarge : public std::runtime_error
+{
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @class TarWriter
+ * @brief Writes files as ustar entries into a gzip stream.
+ */
+class TarWriter
+{
+  public:
+    TarWriter() = delete;
+    TarWriter(const TarWriter&) = delete;
+    TarWriter& operator=(const TarWriter&) = delete;
+    TarWriter(TarWriter&&) = delete;
+    TarWriter& operator=(TarWriter&&) = delete;
+    ~TarWriter() = default;
+
+    /**
+     * @brief Constructs a writer appending to a gzip stream.
+     *
+     * @param[in] out - Receives the archive
+     */
+    explicit TarWriter(GzipStream& out) : out(out) {}
+
+    /**
+     * @brief Appends a regular file to the archive.
+     *
+     * @param[in] file - The file to archive
+     * @param[in] name - Name of the entry, at most 100 characters
+     *
+     * Exceptions: std::system_error if the file cannot be read,
+     *             std::invalid_argument if the entry cannot be represented
+     */
+    void addFile(const std::filesystem::path& file, const std::string& name);
+
+    /**
+     * @brief Writes the end of archive marker and ends the gzip stream.
+     */
+    void finish();
+
+  private:
+    /** @brief Receives the archive */
+    GzipStream& out;
+
+    /** @brief Number of bytes written to the archive */
+    uint64_t written = 0;
+
+    /** @brief Buffer used to copy the files */
+    std::vector<uint8_t> buffer;
+
+    /**
+     * @brief Appends data to the archive.
+     */
+    void write(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Appends zeros up to the next multiple of the given size.
+     */
+    void pad(size_t multiple);
+};
+
+/**
+ * @struct PackageRequest
+ * @brief Contents and destination of a system dump archive.
+ */
+struct PackageRequest
+{
+    /** @brief Directory with plat_dump/ and info.yaml */
+    std::filesystem::path contentDir;
+
+    /** @brief Path of the archive to create */
+    std::filesystem::path output;
+
+    /** @brief Values recorded in the dump header */
+    header::OpDumpHeaderInfo header;
+
+    /** @brief Maximum size of the compressed archive, without header */
+    std::optional<uint64_t> maxSize;
+};
+
+/**
+ * @brief Writes a system dump archive in a single pass.
+ *
+ * The dump header is written first with empty size fields, followed by the
+ * gzip compressed tar of the SBE dump files, the reports written by the
+ * collection and info.yaml. The size fields are then filled in place. The archive is written to a hidden file next to
+ * the output and renamed once complete.
+ *
+ * @param[in] request - What to package and where
+ *
+ * @return Size of the compressed archive, without header
+ *
+ * Exceptions: ArchiveTooLarge if the archive exceeds the maximum size,
+ *             std::exception on any other failure
+ */
+uint64_t packageDump(const PackageRequest& request);
+
+} // namespace openpower::dump::package
@@ -0,0 +1,96 @@
+#include "dump_package.hpp"
+
+#include <unistd.h>
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <CLI/Formatter.hpp>
+
+#include <climits>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+
+int main(int argc, char** argv)
+{
+    using namespace openpower::dump::package;
+
+    CLI::App app{"Dump Packager Application", "dump-package"};
+    app.description(
+        "Packages the collected system dump files with the dump header.\n"
+        "Exits with 2 if the archive exceeds the maximum size.");
+
+    PackageRequest request;
+    std::string contentDir;
+    std::string output;
+    std::optional<uint64_t> maxSize;
+
+    app.add_option("--content, -c", contentDir,
+                   "Directory with plat_dump and info.yaml")
+        ->required();
+
+    app.add_option("--output, -o", output, "Path of the archive to create")
+        ->required();
+
+    app.add_option("--id, -i", request.header.dumpId, "ID of the dump in hex")
+        ->required();
+
+    app.add_option("--eid, -e", request.header.eid,
+                   "Error log ID associated with the dump in hex");
+
+    app.add_option("--serial, -s", request.header.serial,
+                   "System serial number")
+        ->required();
+
+    app.add_option("--model, -m", request.header.model, "System model");
+
+    app.add_option("--time, -t", request.header.timestamp,
+                   "Dump request time as yyyymmddhhmmss")
+        ->required()
+        ->check(openpower::dump::header::checkTimestamp, "yyyymmddhhmmss");
+
+    app.add_option("--name, -n", request.header.systemName,
+                   "System name, defaults to the host name");
+
+    app.add_option("--max-size", maxSize,
+                   "Maximum size of the compressed archive in bytes");
+
+    try
+    {
+        CLI11_PARSE(app, argc, argv);
+    }
+    catch (const CLI::ParseError& e)
+    {
+        return app.exit(e);
+    }
+
+    if (request.header.systemName.empty())
+    {
+        char hostname[HOST_NAME_MAX + 1] = {};
+        gethostname(hostname, sizeof(hostname) - 1);
+        request.header.systemName = hostname;
+    }
+
+    request.contentDir = contentDir;
+    request.output = output;
+    request.maxSize = maxSize;
+
+    try
+    {
+        packageDump(request);
+    }
+    catch (const ArchiveTooLarge& e)
+    {
+        std::cerr << "Failed to package dump: " << e.what() << std::endl;
+        return 2;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to package dump: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return 0;
+}
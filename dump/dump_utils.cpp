@@ -1,11 +1,15 @@
 #include "dump_utils.hpp"
 
+#include "dump_waiter.hpp"
+#include "service_cache.hpp"
+
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/elog.hpp>
 #include <phosphor-logging/lg2.hpp>
 #include <phosphor-logging/log.hpp>
 #include <xyz/openbmc_project/Common/File/error.hpp>
 
+#include <chrono>
 #include <format>
 #include <fstream>
 #include <string>
@@ -16,42 +20,9 @@ using namespace phosphor::logging;
 
 static void monitorDumpCreation(const std::string& path, const uint32_t timeout)
 {
-    bool inProgress = true;
-    auto bus = sdbusplus::bus::new_system();
-    auto match = sdbusplus::match(
-        bus,
-        sdbusplus::match_rules::propertiesChanged(
-            path, "xyz.openbmc_project.Common.Progress"),
-        [&](sdbusplus::message_t& msg) {
-            std::string interface;
-            std::map<std::string, std::variant<std::string, uint8_t>> property;
-            msg.read(interface, property);
-
-            const auto dumpStatus = property.find("Status");
-            if (dumpStatus != property.end())
-            {
-                const std::string* status =
-                    std::get_if<std::string>(&(dumpStatus->second));
-                if (status &&
-                    *status !=
-                        "xyz.openbmc_project.Common.Progress.OperationStatus.InProgress")
-                {
-                    lg2::info("Dump status({STATUS}) : path={PATH}", "STATUS",
-                              status->c_str(), "PATH", path.c_str());
-                    inProgress = false;
-                }
-            }
-        });
-
-    // Timeout management
-    for (uint32_t secondsCount = 0; inProgress && secondsCount < timeout;
-         ++secondsCount)
-    {
-        bus.wait(std::chrono::seconds(1));
-        bus.process_discard();
-    }
-
-    if (inProgress)
+    DumpWaiter waiter;
+    waiter.watch(path);
+    if (!waiter.wait(std::chrono::seconds(timeout)).empty())
     {
         lg2::error("Dump progress timeout; dump may not be complete.");
     }
@@ -59,6 +30,16 @@ static void monitorDumpCreation(const std::string& path, const uint32_t timeout)
 
 void requestSBEDump(const uint32_t failingUnit, const uint32_t eid,
                     SBETypes sbeType)
+{
+    auto path = createSBEDump(failingUnit, eid, sbeType);
+    if (!path.empty())
+    {
+        monitorDumpCreation(path, SBE_DUMP_TIMEOUT);
+    }
+}
+
+std::string createSBEDump(const uint32_t failingUnit, const uint32_t eid,
+                          SBETypes sbeType)
 {
     lg2::info(
         "Requesting Dump PEL({EID}) chip({CHIPTYPE}) position({FAILINGUNIT})",
@@ -72,7 +53,7 @@ void requestSBEDump(const uint32_t failingUnit, const uint32_t eid,
 
     try
     {
-        auto bus = sdbusplus::bus::new_default();
+        auto& bus = getBus();
         auto service = getService(bus, interface, path);
         auto method =
             bus.new_method_call(service.c_str(), path, interface, function);
@@ -88,8 +69,7 @@ void requestSBEDump(const uint32_t failingUnit, const uint32_t eid,
 
         method.append(createParams);
         auto reply = bus.call(method).unpack<sdbusplus::object_path>();
-
-        monitorDumpCreation(reply.str, SBE_DUMP_TIMEOUT);
+        return reply.str;
     }
     catch (const sdbusplus::exception_t& e)
     {
@@ -114,10 +94,26 @@ void requestSBEDump(const uint32_t failingUnit, const uint32_t eid,
     {
         throw e;
     }
+    return {};
+}
+
+sdbusplus::bus_t& getBus()
+{
+    thread_local sdbusplus::bus_t bus = sdbusplus::bus::new_default();
+    return bus;
 }
 
 std::string getService(sdbusplus::bus_t& bus, const std::string& intf,
                        const std::string& path)
+{
+    return ServiceCache::instance().get(intf, path, [&]() {
+        return getServiceFromMapper(bus, intf, path);
+    });
+}
+
+std::string getServiceFromMapper(sdbusplus::bus_t& bus,
+                                 const std::string& intf,
+                                 const std::string& path)
 {
     constexpr auto MAPPER_BUSNAME = "xyz.openbmc_project.ObjectMapper";
     constexpr auto MAPPER_PATH = "/xyz/openbmc_project/object_mapper";
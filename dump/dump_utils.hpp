@@ -49,6 +49,18 @@ struct DumpDataPtr
     uint8_t* dataPtr = nullptr;
 };
 
+/**
+ * @brief Returns the D-Bus connection of the calling thread.
+ *
+ * The connection is opened on the first call from a thread and kept until
+ * the thread exits, so the calls made by a thread share a single socket,
+ * authentication and Hello. sd-bus connections are not thread safe, every
+ * thread gets its own.
+ *
+ * @return The connection of the calling thread
+ */
+sdbusplus::bus_t& getBus();
+
 /**
  * @brief Get DBUS service for input interface via mapper call
  *
@@ -61,6 +73,20 @@ struct DumpDataPtr
 std::string getService(sdbusplus::bus_t& bus, const std::string& intf,
                        const std::string& path);
 
+/**
+ * @brief Get DBUS service for input interface via mapper call, bypassing
+ * the service cache used by getService
+ *
+ * @param[in] bus -  DBUS Bus Object
+ * @param[in] intf - DBUS Interface
+ * @param[in] path - DBUS Object Path
+ *
+ * @return distinct dbus name for input interface/path
+ **/
+std::string getServiceFromMapper(sdbusplus::bus_t& bus,
+                                 const std::string& intf,
+                                 const std::string& path);
+
 /**
  * @brief Set the property value based on the inputs
  *
@@ -97,4 +123,16 @@ void setProperty(const std::string& interface, const std::string& propertyName,
 void requestSBEDump(const uint32_t failingUnit, const uint32_t eid,
                     SBETypes sbeType);
 
+/**
+ * Request SBE dump from the dump manager without waiting for it
+ *
+ * @param failingUnit The id of the proc containing failed SBE
+ * @param eid Error log id associated with dump
+ * @param sbeType Type of the SBE
+ *
+ * @return Object path of the dump entry, empty if the dumps are disabled
+ */
+std::string createSBEDump(const uint32_t failingUnit, const uint32_t eid,
+                          SBETypes sbeType);
+
 } // namespace openpower::dump::util
@@ -0,0 +1,130 @@
+#include "dump_waiter.hpp"
+
+#include "dump_utils.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <cstdint>
+#include <variant>
+
+namespace openpower::dump::util
+{
+
+namespace
+{
+
+constexpr auto progressInterface = "xyz.openbmc_project.Common.Progress";
+constexpr auto statusInProgress =
+    "xyz.openbmc_project.Common.Progress.OperationStatus.InProgress";
+
+using ProgressValue = std::variant<std::string, uint64_t, uint8_t>;
+
+} // namespace
+
+DumpWaiter::DumpWaiter() :
+    event(sdeventplus::Event::get_new()), bus(sdbusplus::bus::new_system())
+{
+    bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
+}
+
+void DumpWaiter::watch(const std::string& path)
+{
+    if (entries.contains(path))
+    {
+        return;
+    }
+
+    auto& entry = entries[path];
+    entry.status = statusInProgress;
+    pending++;
+
+    entry.match = std::make_unique<sdbusplus::match_t>(
+        bus,
+        sdbusplus::match_rules::propertiesChanged(path, progressInterface),
+        [this, path](sdbusplus::message_t& msg) {
+            std::string interface;
+            std::map<std::string, ProgressValue> properties;
+            msg.read(interface, properties);
+
+            auto it = properties.find("Status");
+            if (it != properties.end())
+            {
+                if (auto value = std::get_if<std::string>(&it->second))
+                {
+                    setStatus(path, *value);
+                }
+            }
+        });
+
+    try
+    {
+        auto service = getService(bus, progressInterface, path);
+        auto method = bus.new_method_call(service.c_str(), path.c_str(),
+                                          "org.freedesktop.DBus.Properties",
+                                          "Get");
+        method.append(progressInterface, "Status");
+        auto value = bus.call(method).unpack<ProgressValue>();
+        if (auto status = std::get_if<std::string>(&value))
+        {
+            setStatus(path, *status);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        // The match still reports the completion
+        lg2::error("Failed to read the status of {PATH}, {ERROR}", "PATH",
+                   path, "ERROR", e);
+    }
+}
+
+std::vector<std::string> DumpWaiter::wait(std::chrono::milliseconds timeout)
+{
+    bool expired = false;
+    std::optional<Timer> deadline;
+    if (pending > 0)
+    {
+        auto clock = sdeventplus::Clock<sdeventplus::ClockId::Monotonic>(event);
+        deadline.emplace(event, clock.now() + timeout,
+                         std::chrono::milliseconds(1),
+                         [&expired](Timer&, Timer::TimePoint) {
+                             expired = true;
+                         });
+    }
+
+    while (pending > 0 && !expired)
+    {
+        event.run(std::nullopt);
+    }
+
+    std::vector<std::string> inProgress;
+    for (const auto& [path, entry] : entries)
+    {
+        if (entry.status == statusInProgress)
+        {
+            inProgress.push_back(path);
+        }
+    }
+    return inProgress;
+}
+
+std::string DumpWaiter::status(const std::string& path) const
+{
+    auto it = entries.find(path);
+    return (it != entries.end()) ? it->second.status : std::string{};
+}
+
+void DumpWaiter::setStatus(const std::string& path, const std::string& status)
+{
+    auto& entry = entries.at(path);
+    if (entry.status != statusInProgress || status == statusInProgress)
+    {
+        return;
+    }
+
+    lg2::info("Dump status({STATUS}) : path={PATH}", "STATUS", status, "PATH",
+              path);
+    entry.status = status;
+    pending--;
+}
+
+} // namespace openpower::dump::util
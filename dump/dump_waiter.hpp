@@ -0,0 +1,99 @@
+#pragma once
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdeventplus/clock.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/time.hpp>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace openpower::dump::util
+{
+
+/**
+ * @class DumpWaiter
+ * @brief Waits for dump entries to leave the InProgress status.
+ *
+ * The waiter runs an sd-event loop on a connection of its own, with a
+ * PropertiesChanged match per watched entry and a single deadline timer,
+ * so it wakes up only when a status changes or the deadline passes. Any
+ * number of entries can be watched from one thread.
+ */
+class DumpWaiter
+{
+  public:
+    DumpWaiter(const DumpWaiter&) = delete;
+    DumpWaiter& operator=(const DumpWaiter&) = delete;
+    DumpWaiter(DumpWaiter&&) = delete;
+    DumpWaiter& operator=(DumpWaiter&&) = delete;
+    ~DumpWaiter() = default;
+
+    /**
+     * @brief Opens the connection and the event loop of the waiter.
+     */
+    DumpWaiter();
+
+    /**
+     * @brief Starts watching a dump entry.
+     *
+     * The status is read once the match is in place, so a dump completing
+     * before the call is not missed.
+     *
+     * @param[in] path - Object path of the dump entry
+     */
+    void watch(const std::string& path);
+
+    /**
+     * @brief Waits until every watched entry has left the InProgress
+     * status, or until the timeout expires.
+     *
+     * @param[in] timeout - Longest time to wait
+     *
+     * @return The entries still in progress
+     */
+    std::vector<std::string> wait(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Returns the last status seen for a dump entry.
+     *
+     * @param[in] path - Object path of the dump entry
+     *
+     * @return The status, empty if none was seen
+     */
+    std::string status(const std::string& path) const;
+
+  private:
+    using Timer = sdeventplus::source::Time<sdeventplus::ClockId::Monotonic>;
+
+    /** @brief A watched dump entry */
+    struct Entry
+    {
+        std::unique_ptr<sdbusplus::match_t> match;
+        std::string status;
+    };
+
+    /** @brief Event loop of the waiter */
+    sdeventplus::Event event;
+
+    /** @brief Connection receiving the status changes */
+    sdbusplus::bus_t bus;
+
+    /** @brief Watched entries keyed by path */
+    std::map<std::string, Entry> entries;
+
+    /** @brief Number of watched entries still in progress */
+    size_t pending = 0;
+
+    /**
+     * @brief Records the status of an entry.
+     */
+    void setStatus(const std::string& path, const std::string& status);
+};
+
+} // namespace openpower::dump::util
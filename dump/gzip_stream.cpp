@@ -0,0 +1,85 @@
+#include "gzip_stream.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <system_error>
+
+namespace openpower::dump
+{
+
+namespace
+{
+
+/** @brief Size of the buffer receiving the compressed data */
+constexpr size_t compressedChunkSize = 64 * 1024;
+
+/** @brief zlib window bits selecting a gzip wrapper */
+constexpr int gzipWindowBits = 15 + 16;
+
+/** @brief zlib default memory level */
+constexpr int memLevel = 8;
+
+} // namespace
+
+GzipStream::GzipStream(Sink sink, int level) :
+    sink(std::move(sink)), stream(std::make_unique<z_stream_s>()),
+    outBuffer(compressedChunkSize)
+{
+    if (deflateInit2(stream.get(), level, Z_DEFLATED, gzipWindowBits,
+                     memLevel, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        throw std::system_error(ENOMEM, std::generic_category(),
+                                "Failed to initialize compression");
+    }
+}
+
+GzipStream::~GzipStream()
+{
+    deflateEnd(stream.get());
+}
+
+void GzipStream::deflateData(const uint8_t* data, size_t len, int flush)
+{
+    // avail_in is 32 bits wide, feed larger buffers in slices
+    constexpr size_t maxInput = std::numeric_limits<uInt>::max();
+    do
+    {
+        auto slice = std::min(len, maxInput);
+        stream->next_in = const_cast<uint8_t*>(data);
+        stream->avail_in = slice;
+        data += slice;
+        len -= slice;
+
+        auto mode = (len == 0) ? flush : Z_NO_FLUSH;
+        do
+        {
+            stream->next_out = outBuffer.data();
+            stream->avail_out = outBuffer.size();
+            if (deflate(stream.get(), mode) == Z_STREAM_ERROR)
+            {
+                throw std::system_error(EIO, std::generic_category(),
+                                        "Failed to compress the data");
+            }
+            auto produced = outBuffer.size() - stream->avail_out;
+            if (produced > 0)
+            {
+                sink(outBuffer.data(), produced);
+            }
+        } while (stream->avail_out == 0);
+    } while (len > 0);
+}
+
+void GzipStream::write(const uint8_t* data, size_t len)
+{
+    deflateData(data, len, Z_NO_FLUSH);
+}
+
+void GzipStream::finish()
+{
+    deflateData(nullptr, 0, Z_FINISH);
+}
+
+} // namespace openpower::dump
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+struct z_stream_s;
+
+namespace openpower::dump
+{
+
+/**
+ * @class GzipStream
+ * @brief Compresses data into a single gzip member as it is written.
+ *
+ * The compressed output is handed to the sink in chunks as it is produced,
+ * so the stream never holds more than one output chunk.
+ */
+class GzipStream
+{
+  public:
+    /** @brief Receives the compressed output */
+    using Sink = std::function<void(const uint8_t* data, size_t len)>;
+
+    GzipStream() = delete;
+    GzipStream(const GzipStream&) = delete;
+    GzipStream& operator=(const GzipStream&) = delete;
+    GzipStream(GzipStream&&) = delete;
+    GzipStream& operator=(GzipStream&&) = delete;
+
+    /**
+     * @brief Starts a gzip member.
+     *
+     * @param[in] sink - Receives the compressed output
+     * @param[in] level - zlib compression level
+     *
+     * Exceptions: std::system_error if zlib cannot be initialized
+     */
+    explicit GzipStream(Sink sink, int level);
+
+    ~GzipStream();
+
+    /**
+     * @brief Compresses data.
+     *
+     * @param[in] data - Data to compress
+     * @param[in] len - Length of the data
+     *
+     * Exceptions: std::system_error on compression failure, or any
+     *             exception raised by the sink
+     */
+    void write(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Flushes the pending data and ends the gzip member.
+     *
+     * Exceptions: std::system_error on compression failure, or any
+     *             exception raised by the sink
+     */
+    void finish();
+
+  private:
+    /** @brief Receives the compressed output */
+    Sink sink;
+
+    /** @brief Deflate state */
+    std::unique_ptr<z_stream_s> stream;
+
+    /** @brief Compressed data waiting for the sink */
+    std::vector<uint8_t> outBuffer;
+
+    /**
+     * @brief Runs deflate over the input and passes the output to the sink.
+     *
+     * @param[in] flush - The zlib flush mode
+     */
+    void deflateData(const uint8_t* data, size_t len, int flush);
+};
+
+} // namespace openpower::dump
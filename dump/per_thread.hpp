@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace openpower::dump
+{
+
+namespace detail
+{
+
+/** @brief Returns an id never handed out before in the process */
+inline uint64_t nextPerThreadGeneration()
+{
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+/**
+ * @class PerThread
+ * @brief A value of each thread using the object.
+ *
+ * A thread finds its value through a thread local cache, so local() only
+ * takes a lock the first time a thread uses the object, and the values of
+ * the threads do not share cache lines. The values are read with forEach()
+ * once the threads using them are done, e.g. after waiting for the worker
+ * pools.
+ */
+template <typename T>
+class PerThread
+{
+  public:
+    PerThread() : generation(detail::nextPerThreadGeneration()) {}
+    PerThread(const PerThread&) = delete;
+    PerThread& operator=(const PerThread&) = delete;
+    PerThread(PerThread&&) = delete;
+    PerThread& operator=(PerThread&&) = delete;
+    ~PerThread() = default;
+
+    /**
+     * @brief Returns the value of the calling thread.
+     */
+    T& local()
+    {
+        if (cache.first != generation)
+        {
+            std::lock_guard lock(mutex);
+            cache = {generation, &slots.emplace_back().value};
+        }
+        return *cache.second;
+    }
+
+    /**
+     * @brief Calls func(index, value) for the value of each thread, in the
+     * order the threads first used the object.
+     */
+    template <typename Func>
+    void forEach(Func&& func) const
+    {
+        std::lock_guard lock(mutex);
+        size_t index = 0;
+        for (const auto& slot : slots)
+        {
+            func(index++, slot.value);
+        }
+    }
+
+  private:
+    /** @brief Value of a thread, alone on its cache lines */
+    struct alignas(64) Slot
+    {
+        T value{};
+    };
+
+    /** @brief Generation and value the thread last used */
+    static thread_local std::pair<uint64_t, T*> cache;
+
+    /** @brief Identifies the object in the thread local caches */
+    const uint64_t generation;
+
+    /** @brief Protects the list of slots, not the values */
+    mutable std::mutex mutex;
+
+    /** @brief Values of the threads, never moved */
+    std::deque<Slot> slots;
+};
+
+template <typename T>
+thread_local std::pair<uint64_t, T*> PerThread<T>::cache{0, nullptr};
+
+} // namespace openpower::dump
@@ -0,0 +1,372 @@
+extern "C"
+{
+#include <libpdbg.h>
+#include <libpdbg_sbe.h>
+}
+
+#include "phal_chipop_backend.hpp"
+
+#include <libphal.H>
+#include <phal_exception.H>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace openpower::dump::sbe_chipop
+{
+
+using namespace openpower::phal::dump;
+
+namespace
+{
+
+/** @brief Device tree used by pdbg when PDBG_DTB is not set */
+constexpr auto defaultDtb = "/var/lib/phal/exportdevtree";
+
+/** @brief Location code of a target, empty if it has none */
+std::string getLocationCode(struct pdbg_target* target)
+{
+    try
+    {
+        ATTR_LOCATION_CODE_Type locationCode{};
+        openpower::phal::pdbg::getLocationCode(target, locationCode);
+        return std::string(locationCode,
+                           strnlen(locationCode, sizeof(locationCode)));
+    }
+    catch (const std::exception& e)
+    {
+        lg2::info("No location code for {TARGET}, {ERROR}", "TARGET",
+                  pdbg_target_path(target), "ERROR", e);
+        return {};
+    }
+}
+
+/** @brief Whether a probed target can service chip-ops */
+bool isFunctional(struct pdbg_target* target)
+{
+    return pdbg_target_probe(target) == PDBG_TARGET_ENABLED &&
+           openpower::phal::pdbg::isTgtFunctional(target);
+}
+
+/** @brief FSI link of an OCMB, used to tell the links apart */
+uint32_t getOcmbLink(struct pdbg_target* ocmbTarget)
+{
+    // Odyssey chip-ops go through the FSI link of the OCMB, use its
+    // index to tell the links apart.
+    uint32_t link = pdbg_target_index(ocmbTarget);
+    struct pdbg_target* fsiTarget;
+    pdbg_for_each_target("fsi", ocmbTarget, fsiTarget)
+    {
+        link = pdbg_target_index(fsiTarget);
+        break;
+    }
+    return link;
+}
+
+} // namespace
+
+void PhalChipOpBackend::initialize()
+{
+    // The device tree stays valid for the life of the process, a collector
+    // reused for several dumps only pays for it once
+    std::call_once(initialized, []() { openpower::phal::pdbg::init(); });
+
+    std::lock_guard lock(topologyMutex);
+    refreshTopology();
+}
+
+void PhalChipOpBackend::initializeHwps()
+{
+    std::call_once(hwpsInitialized, []() { initializePdbgLibEkb(); });
+}
+
+std::vector<Chip> PhalChipOpBackend::getFunctionalProcs()
+{
+    std::lock_guard lock(topologyMutex);
+    return procs;
+}
+
+std::vector<Chip> PhalChipOpBackend::getFunctionalOcmbs(const Chip& proc)
+{
+    std::lock_guard lock(topologyMutex);
+    auto it = ocmbs.find(proc.position);
+    return (it != ocmbs.end()) ? it->second : std::vector<Chip>{};
+}
+
+void PhalChipOpBackend::refreshTopology()
+{
+    const char* dtb = std::getenv("PDBG_DTB");
+    auto key = TopologyKey::current(dtb != nullptr ? dtb : defaultDtb);
+    if (key && topologyKey == key)
+    {
+        return;
+    }
+
+    if (key)
+    {
+        if (auto snapshot = TopologySnapshot::load(snapshotPath, *key))
+        {
+            loadTopology(*snapshot);
+            topologyKey = key;
+            lg2::info("Loaded the topology snapshot {PATH}, {PROCS} procs",
+                      "PATH", snapshotPath, "PROCS", procs.size());
+            return;
+        }
+    }
+
+    auto snapshot = discoverTopology();
+    // Without a key the snapshot cannot be validated, discover again next
+    // time
+    topologyKey = key;
+    if (!key)
+    {
+        return;
+    }
+
+    snapshot.key = *key;
+    try
+    {
+        snapshot.save(snapshotPath);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to save the topology snapshot {PATH}, {ERROR}",
+                   "PATH", snapshotPath, "ERROR", e);
+    }
+}
+
+void PhalChipOpBackend::loadTopology(const TopologySnapshot& snapshot)
+{
+    procs.clear();
+    ocmbs.clear();
+
+    auto find = [&snapshot](SBETypes sbeType, uint32_t position,
+                            uint32_t parent) -> const TopologyEntry* {
+        for (const auto& entry : snapshot.entries)
+        {
+            if (entry.sbeType == sbeType && entry.position == position &&
+                (sbeType == SBETypes::PROC || entry.parent == parent))
+            {
+                return entry.functional ? &entry : nullptr;
+            }
+        }
+        return nullptr;
+    };
+
+    // The targets are still probed before use, the snapshot only saves
+    // probing the ones that are not functional and reading their state
+    struct pdbg_target* target = nullptr;
+    pdbg_for_each_class_target("proc", target)
+    {
+        auto procPos = pdbg_target_index(target);
+        if (find(SBETypes::PROC, procPos, 0) == nullptr ||
+            pdbg_target_probe(target) != PDBG_TARGET_ENABLED)
+        {
+            continue;
+        }
+        procs.push_back({SBETypes::PROC, procPos, target});
+
+        auto& procOcmbs = ocmbs[procPos];
+        struct pdbg_target* ocmbTarget;
+        pdbg_for_each_target("ocmb", target, ocmbTarget)
+        {
+            auto entry = find(SBETypes::OCMB, pdbg_target_index(ocmbTarget),
+                              procPos);
+            if (entry == nullptr ||
+                pdbg_target_probe(ocmbTarget) != PDBG_TARGET_ENABLED)
+            {
+                continue;
+            }
+            procOcmbs.push_back(
+                {SBETypes::OCMB, entry->position, ocmbTarget, entry->link});
+        }
+    }
+}
+
+TopologySnapshot PhalChipOpBackend::discoverTopology()
+{
+    TopologySnapshot snapshot;
+    procs.clear();
+    ocmbs.clear();
+
+    struct pdbg_target* target = nullptr;
+    pdbg_for_each_class_target("proc", target)
+    {
+        TopologyEntry proc;
+        proc.sbeType = SBETypes::PROC;
+        proc.position = pdbg_target_index(target);
+        proc.functional = isFunctional(target);
+        proc.locationCode = getLocationCode(target);
+        snapshot.entries.push_back(proc);
+        if (!proc.functional)
+        {
+            continue;
+        }
+        procs.push_back({SBETypes::PROC, proc.position, target});
+
+        auto& procOcmbs = ocmbs[proc.position];
+        struct pdbg_target* ocmbTarget;
+        pdbg_for_each_target("ocmb", target, ocmbTarget)
+        {
+            if (!is_ody_ocmb_chip(ocmbTarget))
+            {
+                continue;
+            }
+
+            TopologyEntry ocmb;
+            ocmb.sbeType = SBETypes::OCMB;
+            ocmb.position = pdbg_target_index(ocmbTarget);
+            ocmb.parent = proc.position;
+            ocmb.link = getOcmbLink(ocmbTarget);
+            ocmb.functional = isFunctional(ocmbTarget);
+            ocmb.locationCode = getLocationCode(ocmbTarget);
+            snapshot.entries.push_back(ocmb);
+            if (ocmb.functional)
+            {
+                procOcmbs.push_back(
+                    {SBETypes::OCMB, ocmb.position, ocmbTarget, ocmb.link});
+            }
+        }
+    }
+    return snapshot;
+}
+
+void PhalChipOpBackend::threadStop(const Chip& proc)
+{
+    openpower::phal::sbe::threadStopProc(proc.target);
+}
+
+void PhalChipOpBackend::getDump(const Chip& chip, uint8_t type,
+                                uint8_t clockState, uint8_t collectFastArray,
+                                const DumpChunkHandler& handler)
+{
+    // The whole dump is held until it is written. The sbefifo driver runs a
+    // chip-op within a single read, which fails unless the buffer fits the
+    // complete response, so libphal and the pdbg sbefifo API both hand over
+    // the dump in one buffer. Reading the response in bounded chunks needs
+    // the driver to return it across reads. Pass the buffer on in chunks
+    // and release it as soon as it is written.
+    util::DumpDataPtr dataPtr;
+    uint32_t len = 0;
+
+    auto streamData = [&]() {
+        const uint8_t* data = dataPtr.getData();
+        for (uint32_t offset = 0; data != nullptr && offset < len;)
+        {
+            size_t chunk = std::min<size_t>(dumpChunkSize, len - offset);
+            handler(data + offset, chunk);
+            offset += chunk;
+        }
+    };
+
+    try
+    {
+        openpower::phal::sbe::getDump(chip.target, type, clockState,
+                                      collectFastArray, dataPtr.getPtr(), &len);
+    }
+    catch (const openpower::phal::sbeError_t& sbeError)
+    {
+        if (sbeError.errType() ==
+            openpower::phal::exception::SBE_INTERNAL_FFDC_DATA)
+        {
+            streamData();
+        }
+        throw;
+    }
+    streamData();
+}
+
+SbeDumpTarget PhalChipOpBackend::prepareSbeDump(uint32_t failingUnit,
+                                                int sbeTypeId)
+{
+    initializeHwps();
+
+    SbeDumpTarget sbeTarget;
+    if (PROC_SBE_DUMP == sbeTypeId)
+    {
+        // A functional proc of the snapshot is already probed
+        std::lock_guard lock(topologyMutex);
+        refreshTopology();
+        auto it = std::ranges::find(procs, failingUnit, &Chip::position);
+        if (it != procs.end())
+        {
+            sbeTarget.chip.target = it->target;
+        }
+    }
+    if (sbeTarget.chip.target == nullptr)
+    {
+        sbeTarget.chip.target = getTargetFromFailingId(failingUnit, sbeTypeId);
+    }
+    sbeTarget.chip.position = failingUnit;
+    if (PROC_SBE_DUMP == sbeTypeId)
+    {
+        sbeTarget.chip.sbeType = SBETypes::PROC;
+        sbeTarget.access = probeTarget(sbeTarget.chip.target, "pib", sbeTypeId);
+    }
+    else
+    {
+        sbeTarget.chip.sbeType = SBETypes::OCMB;
+        sbeTarget.access = probeTarget(sbeTarget.chip.target, "fsi", sbeTypeId);
+    }
+    return sbeTarget;
+}
+
+void PhalChipOpBackend::checkSbeState(const SbeDumpTarget& target,
+                                      int sbeTypeId)
+{
+    openpower::phal::dump::checkSbeState(target.access, sbeTypeId);
+}
+
+void PhalChipOpBackend::executeSbeExtractRc(
+    const SbeDumpTarget& target, const std::filesystem::path& dumpPath,
+    int sbeTypeId)
+{
+    openpower::phal::dump::executeSbeExtractRc(target.chip.target, dumpPath,
+                                               sbeTypeId);
+}
+
+void PhalChipOpBackend::collectLocalRegDump(
+    const SbeDumpTarget& target, const std::filesystem::path& dumpPath,
+    const std::string& baseFilename, int sbeTypeId)
+{
+    openpower::phal::dump::collectLocalRegDump(target.chip.target, dumpPath,
+                                               baseFilename, sbeTypeId);
+}
+
+void PhalChipOpBackend::collectPIBMSRegDump(
+    const SbeDumpTarget& target, const std::filesystem::path& dumpPath,
+    const std::string& baseFilename, int sbeTypeId)
+{
+    openpower::phal::dump::collectPIBMSRegDump(target.chip.target, dumpPath,
+                                               baseFilename, sbeTypeId);
+}
+
+void PhalChipOpBackend::collectPIBMEMDump(
+    const SbeDumpTarget& target, const std::filesystem::path& dumpPath,
+    const std::string& baseFilename, int sbeTypeId)
+{
+    openpower::phal::dump::collectPIBMEMDump(target.chip.target, dumpPath,
+                                             baseFilename, sbeTypeId);
+}
+
+void PhalChipOpBackend::collectPPEState(
+    const SbeDumpTarget& target, const std::filesystem::path& dumpPath,
+    const std::string& baseFilename, int sbeTypeId)
+{
+    openpower::phal::dump::collectPPEState(target.chip.target, dumpPath,
+                                           baseFilename, sbeTypeId);
+}
+
+void PhalChipOpBackend::finalizeSbeDump(const SbeDumpTarget& target,
+                                        const std::filesystem::path& dumpPath,
+                                        bool success, int sbeTypeId)
+{
+    openpower::phal::dump::finalizeCollection(target.access, dumpPath, success,
+                                              sbeTypeId);
+}
+
+} // namespace openpower::dump::sbe_chipop
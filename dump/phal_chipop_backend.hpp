@@ -0,0 +1,126 @@
+#pragma once
+
+#include "chipop_backend.hpp"
+#include "topology_snapshot.hpp"
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace openpower::dump::sbe_chipop
+{
+
+/**
+ * @class PhalChipOpBackend
+ * @brief Chip-op backend driving the hardware through pdbg and libphal.
+ *
+ * The functional procs and OCMBs are discovered once per host boot and
+ * saved in a topology snapshot. While the snapshot is valid a collection
+ * only probes the functional targets it lists.
+ */
+class PhalChipOpBackend : public ChipOpBackend
+{
+  public:
+    PhalChipOpBackend() = default;
+    ~PhalChipOpBackend() override = default;
+
+    /**
+     * @param[in] snapshotPath - Location of the topology snapshot
+     */
+    explicit PhalChipOpBackend(std::filesystem::path snapshotPath) :
+        snapshotPath(std::move(snapshotPath))
+    {}
+
+    void initialize() override;
+
+    void initializeHwps() override;
+
+    std::vector<Chip> getFunctionalProcs() override;
+
+    std::vector<Chip> getFunctionalOcmbs(const Chip& proc) override;
+
+    void threadStop(const Chip& proc) override;
+
+    void getDump(const Chip& chip, uint8_t type, uint8_t clockState,
+                 uint8_t collectFastArray,
+                 const DumpChunkHandler& handler) override;
+
+    SbeDumpTarget prepareSbeDump(uint32_t failingUnit, int sbeTypeId) override;
+
+    void checkSbeState(const SbeDumpTarget& target, int sbeTypeId) override;
+
+    void executeSbeExtractRc(const SbeDumpTarget& target,
+                             const std::filesystem::path& dumpPath,
+                             int sbeTypeId) override;
+
+    void collectLocalRegDump(const SbeDumpTarget& target,
+                             const std::filesystem::path& dumpPath,
+                             const std::string& baseFilename,
+                             int sbeTypeId) override;
+
+    void collectPIBMSRegDump(const SbeDumpTarget& target,
+                             const std::filesystem::path& dumpPath,
+                             const std::string& baseFilename,
+                             int sbeTypeId) override;
+
+    void collectPIBMEMDump(const SbeDumpTarget& target,
+                           const std::filesystem::path& dumpPath,
+                           const std::string& baseFilename,
+                           int sbeTypeId) override;
+
+    void collectPPEState(const SbeDumpTarget& target,
+                         const std::filesystem::path& dumpPath,
+                         const std::string& baseFilename,
+                         int sbeTypeId) override;
+
+    void finalizeSbeDump(const SbeDumpTarget& target,
+                         const std::filesystem::path& dumpPath, bool success,
+                         int sbeTypeId) override;
+
+  private:
+    /** @brief pdbg is initialized once per process */
+    std::once_flag initialized;
+
+    /** @brief libekb is loaded once per process */
+    std::once_flag hwpsInitialized;
+
+    /** @brief Location of the topology snapshot */
+    std::filesystem::path snapshotPath = topologySnapshotPath;
+
+    /** @brief Protects the members below */
+    std::mutex topologyMutex;
+
+    /** @brief Key of the topology in use, unset to discover it again */
+    std::optional<TopologyKey> topologyKey;
+
+    /** @brief Functional procs, probed */
+    std::vector<Chip> procs;
+
+    /** @brief Functional OCMBs, probed, keyed by the position of the proc */
+    std::map<uint32_t, std::vector<Chip>> ocmbs;
+
+    /**
+     * @brief Makes the topology current, from the snapshot when it is
+     * valid or by probing every target. Called with the mutex held.
+     */
+    void refreshTopology();
+
+    /**
+     * @brief Probes the functional targets listed in a snapshot.
+     *
+     * @param[in] snapshot - A valid snapshot
+     */
+    void loadTopology(const TopologySnapshot& snapshot);
+
+    /**
+     * @brief Probes every proc and OCMB target.
+     *
+     * @return The snapshot of the topology found, without a key
+     */
+    TopologySnapshot discoverTopology();
+};
+
+} // namespace openpower::dump::sbe_chipop
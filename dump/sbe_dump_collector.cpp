@@ -1,10 +1,7 @@
-extern "C"
-{
-#include <libpdbg.h>
-#include <libpdbg_sbe.h>
-}
-
+#include "chipop_deadline.hpp"
 #include "create_pel.hpp"
+#include "dump_waiter.hpp"
+#include "phal_chipop_backend.hpp"
 #include "sbe_consts.hpp"
 #include "sbe_dump_collector.hpp"
 #include "sbe_type.hpp"
@@ -13,6 +10,7 @@ extern "C"
 #include <libphal.H>
 #include <phal_exception.H>
 
+#include <nlohmann/json.hpp>
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/lg2.hpp>
 #include <phosphor-logging/log.hpp>
@@ -20,12 +18,21 @@ extern "C"
 #include <xyz/openbmc_project/Common/File/error.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <exception>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <stdexcept>
+#include <system_error>
+#include <thread>
 
 namespace openpower::dump::sbe_chipop
 {
@@ -35,112 +42,307 @@ using namespace openpower::dump::SBE;
 using namespace openpower::phal::dump;
 using Severity = sdbusplus::xyz::openbmc_project::Logging::server::Entry::Level;
 
+namespace
+{
+
+const char* toString(ChipOpStatus status)
+{
+    switch (status)
+    {
+        case ChipOpStatus::collected:
+            return "collected";
+        case ChipOpStatus::failed:
+            return "failed";
+        case ChipOpStatus::skipped:
+            return "skipped";
+        case ChipOpStatus::abandoned:
+            return "abandoned";
+    }
+    return "unknown";
+}
+
+const char* clockStateName(uint8_t clockState)
+{
+    return clockState == SBE_CLOCK_ON ? "on" : "off";
+}
+
+int64_t toMs(std::chrono::steady_clock::duration elapsed)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+        .count();
+}
+
+} // namespace
+
+/**
+ * @struct SbeDumpCollector::CollectionState
+ * @brief Timings, errors and requested dumps of a running collection.
+ *
+ * Every collection has its own, so collections running at the same time do
+ * not mix their reports.
+ */
+struct SbeDumpCollector::CollectionState
+{
+    /** @brief Latencies measured by the collection threads */
+    CollectionTiming timing;
+
+    /** @brief Steps run by the collection threads, nullptr if not traced */
+    std::unique_ptr<TraceRecorder> trace;
+
+    /** @brief SBE dumps requested, only written by the reporter thread */
+    std::vector<std::string> nestedDumps;
+
+    /** @brief Time allowed for the collection, 0 for no limit */
+    std::chrono::seconds timeAllowed{0};
+
+    /** @brief Time the chip-ops are no longer waited for, none if unset */
+    ChipOpLimit deadline;
+
+    /** @brief Protects chipOps */
+    std::mutex manifestMutex;
+
+    /** @brief Outcome of each chip-op, written in manifest.json */
+    nlohmann::json chipOps = nlohmann::json::array();
+
+    /** @brief Thread creating the PELs, joined before the state above */
+    WorkerPool reporter{1};
+
+    /**
+     * @brief Returns the time a chip-op starting now is abandoned at.
+     *
+     * The time left until the deadline is shared evenly by the chip-ops
+     * still to run one after the other on the chip, so a chip-op gets the
+     * time left unused by the earlier ones. Once the deadline is reached
+     * the chip-ops are given no time at all.
+     *
+     * @param steps - Chip-ops left to run one after the other, this one
+     * included
+     */
+    ChipOpLimit chipOpLimit(size_t steps) const
+    {
+        if (!deadline)
+        {
+            return std::nullopt;
+        }
+        auto now = CollectionTiming::Clock::now();
+        if (now >= *deadline)
+        {
+            return now;
+        }
+        auto count = static_cast<CollectionTiming::Clock::rep>(
+            std::max<size_t>(steps, 1));
+        return now + (*deadline - now) / count;
+    }
+
+    /**
+     * @brief Records the outcome of a chip-op in the manifest.
+     *
+     * @param chip - Chip of the chip-op
+     * @param chipOp - Details of the chip-op
+     * @param status - Outcome of the chip-op
+     */
+    void record(const Chip& chip, nlohmann::json chipOp, ChipOpStatus status)
+    {
+        chipOp["chip"] = sbeTypeAttributes.at(chip.sbeType).chipName;
+        chipOp["position"] = chip.position;
+        chipOp["status"] = toString(status);
+        std::lock_guard lock(manifestMutex);
+        chipOps.push_back(std::move(chipOp));
+    }
+};
+
+SbeDumpCollector::SbeDumpCollector() :
+    backend(std::make_unique<PhalChipOpBackend>())
+{}
+
 void SbeDumpCollector::collectDump(uint8_t type, uint32_t id,
                                    uint32_t failingUnit,
-                                   const std::filesystem::path& path)
+                                   const std::filesystem::path& path,
+                                   std::chrono::seconds deadline)
 {
     if ((type == SBE_DUMP_TYPE_SBE) || (type == SBE_DUMP_TYPE_MSBE))
     {
         collectSBEDump(id, failingUnit, path, type);
         return;
     }
-    collectHWHBDump(type, id, failingUnit, path);
+    collectHWHBDump(type, id, failingUnit, path, deadline);
+}
+
+void SbeDumpCollector::initialize()
+{
+    backend->initializeHwps();
+    backend->initialize();
 }
 
 void SbeDumpCollector::collectHWHBDump(uint8_t type, uint32_t id,
                                        uint64_t failingUnit,
-                                       const std::filesystem::path& path)
+                                       const std::filesystem::path& path,
+                                       std::chrono::seconds deadline)
 {
     lg2::error("Starting dump collection: type:{TYPE} id:{ID} "
-               "failingUnit:{FAILINGUNIT}, path:{PATH}",
+               "failingUnit:{FAILINGUNIT}, path:{PATH} deadline:{DEADLINE}s",
                "TYPE", type, "ID", id, "FAILINGUNIT", failingUnit, "PATH",
-               path.string());
+               path.string(), "DEADLINE", deadline.count());
 
-    initializePdbg();
+    // The PELs of the chip-op failures are created on a thread of their own,
+    // so a slow logging service does not hold the collection back
+    CollectionState collection;
+    if (traceEnabled)
+    {
+        collection.trace = std::make_unique<TraceRecorder>();
+    }
+    if (deadline.count() > 0)
+    {
+        collection.timeAllowed = deadline;
+        collection.deadline = CollectionTiming::Clock::now() + deadline;
+    }
 
-    TargetMap targets;
+    std::vector<Chip> procs;
+    {
+        PhaseTimer timer(collection.timing, TimingPhase::discovery);
+        TraceSpan span(collection.trace.get(), "discovery", "procs");
+        backend->initialize();
+        procs = backend->getFunctionalProcs();
+    }
 
-    struct pdbg_target* target = nullptr;
-    pdbg_for_each_class_target("proc", target)
+    std::vector<uint8_t> clockStates = {SBE_CLOCK_ON};
+    // Skip collection for performance dump if clock state is not ON
+    if (type != SBE_DUMP_TYPE_PERFORMANCE)
     {
-        if (pdbg_target_probe(target) != PDBG_TARGET_ENABLED ||
-            !openpower::phal::pdbg::isTgtFunctional(target))
-        {
-            continue;
-        }
+        clockStates.push_back(SBE_CLOCK_OFF);
+    }
+
+    WorkerPool pool(workerCount != 0 ? workerCount : defaultWorkerCount());
+    std::vector<char> includeTargets(procs.size(), true);
 
-        bool includeTarget = true;
-        // if the dump type is hostboot then call stop instructions
-        if (type == SBE_DUMP_TYPE_HOSTBOOT)
+    // if the dump type is hostboot then call stop instructions, the
+    // instructions are stopped on all the procs before collecting any dump
+    if (type == SBE_DUMP_TYPE_HOSTBOOT)
+    {
+        for (size_t i = 0; i < procs.size(); i++)
         {
-            includeTarget = executeThreadStop(target, path);
+            pool.submit([this, &procs, &includeTargets, &path, &collection,
+                         &clockStates, i]() {
+                // The thread stop is followed by the dumps of the proc
+                auto limit = collection.chipOpLimit(1 + clockStates.size());
+                includeTargets[i] =
+                    executeThreadStop(procs[i], path, collection, limit);
+            });
         }
-        if (includeTarget)
+        pool.wait();
+    }
+
+    TargetMap targets;
+    for (size_t i = 0; i < procs.size(); i++)
+    {
+        if (includeTargets[i])
         {
-            targets[target] = std::vector<struct pdbg_target*>();
+            ProcTargets procTargets;
+            procTargets.maxOcmbsPerProc = ocmbConcurrency.perProc;
+            procTargets.maxOcmbsPerLink = ocmbConcurrency.perLink;
 
             // Hardware dump needs OCMB data if present
             if (type == openpower::dump::SBE::SBE_DUMP_TYPE_HARDWARE)
             {
-                struct pdbg_target* ocmbTarget;
-                pdbg_for_each_target("ocmb", target, ocmbTarget)
-                {
-                    if (!is_ody_ocmb_chip(ocmbTarget))
-                    {
-                        continue;
-                    }
-
-                    if (pdbg_target_probe(ocmbTarget) != PDBG_TARGET_ENABLED)
-                    {
-                        continue;
-                    }
-
-                    if (!openpower::phal::pdbg::isTgtFunctional(ocmbTarget))
-                    {
-                        continue;
-                    }
-                    targets[target].push_back(ocmbTarget);
-                }
+                PhaseTimer timer(collection.timing, TimingPhase::discovery);
+                TraceSpan span(collection.trace.get(), "discovery",
+                               std::format("ocmbs of proc{}",
+                                           procs[i].position));
+                procTargets.ocmbs = backend->getFunctionalOcmbs(procs[i]);
             }
+            targets[procs[i]] = std::move(procTargets);
         }
     }
 
-    std::vector<uint8_t> clockStates = {SBE_CLOCK_ON, SBE_CLOCK_OFF};
-    for (auto cstate : clockStates)
+    // Each proc runs through all the clock states on its own, so a slow
+    // proc or a long OCMB chain only delays the dumps of that proc.
+    for (const auto& [procTarget, procTargets] : targets)
     {
-        // Skip collection for performance dump if clock state is not ON
-        if (type == SBE_DUMP_TYPE_PERFORMANCE && cstate != SBE_CLOCK_ON)
-        {
-            continue;
-        }
-        auto futures = spawnDumpCollectionProcesses(type, id, path, failingUnit,
-                                                    cstate, targets);
+        auto pipeline = std::make_shared<ProcPipeline>(
+            procTarget, procTargets, path, id, type, failingUnit, clockStates,
+            collection);
+        pool.submit([this, &pool, pipeline]() {
+            runProcPipeline(pool, pipeline, 0);
+        });
+    }
+
+    // Wait for all the collection tasks to complete, and for the errors
+    // they reported to be in the dump
+    pool.wait();
+    collection.reporter.wait();
+    reportNestedDumps(collection);
+
+    auto timing = collection.timing.summarize();
+    {
+        std::lock_guard lock(timingMutex);
+        lastTimingSummary = timing;
+    }
 
-        // Wait for all asynchronous tasks to complete
-        for (auto& future : futures)
+    if (std::filesystem::is_empty(path))
+    {
+        lg2::error("Failed to collect the dump");
+        throw std::runtime_error("Failed to collect the dump");
+    }
+
+    std::ofstream timingFile(path / "timing.json");
+    timingFile << timing.toJson().dump(4) << std::endl;
+    if (!timingFile)
+    {
+        lg2::error("Failed to write the dump timings in {PATH}", "PATH",
+                   path.string());
+    }
+    writeManifest(collection, path);
+    writeTrace(collection.trace.get(), path);
+    lg2::info("Dump collection completed in {ELAPSED}ms", "ELAPSED",
+              timing.totalUs / 1000);
+}
+
+void SbeDumpCollector::reportNestedDumps(CollectionState& collection)
+{
+    const auto& paths = collection.nestedDumps;
+    if (paths.empty())
+    {
+        return;
+    }
+
+    // The dumps are not waited for past the deadline of the collection
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+        nestedDumpWait);
+    if (collection.deadline)
+    {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            *collection.deadline - CollectionTiming::Clock::now());
+        wait = std::clamp(left, std::chrono::milliseconds{0}, wait);
+    }
+
+    std::vector<std::string> inProgress = paths;
+    if (wait.count() > 0)
+    {
+        try
         {
-            try
-            {
-                future.wait();
-            }
-            catch (const std::exception& e)
+            PhaseTimer timer(collection.timing, TimingPhase::nestedDumpWait);
+            TraceSpan span(collection.trace.get(), "nested", "wait",
+                           {{"dumps", paths.size()}});
+            util::DumpWaiter waiter;
+            for (const auto& path : paths)
             {
-                lg2::error("Failed to collect dump from SBE ErrorMsg({ERROR})",
-                           "ERROR", e);
+                waiter.watch(path);
             }
+            inProgress = waiter.wait(wait);
+        }
+        catch (const std::exception& e)
+        {
+            lg2::error("Failed to wait for the SBE dumps, {ERROR}", "ERROR",
+                       e);
         }
-        lg2::info(
-            "Dump collection completed for clock state({CSTATE}): type({TYPE}) "
-            "id({ID}) failingUnit({FAILINGUNIT}), path({PATH})",
-            "CSTATE", cstate, "TYPE", type, "ID", id, "FAILINGUNIT",
-            failingUnit, "PATH", path.string());
     }
-    if (std::filesystem::is_empty(path))
+
+    for (const auto& path : paths)
     {
-        lg2::error("Failed to collect the dump");
-        throw std::runtime_error("Failed to collect the dump");
+        auto running = std::ranges::find(inProgress, path) != inProgress.end();
+        lg2::info("SBE dump {PATH} requested during the collection {STATE}",
+                  "PATH", path, "STATE", running ? "in progress" : "completed");
     }
-    lg2::info("Dump collection completed");
 }
 
 void SbeDumpCollector::collectSBEDump(uint32_t id, uint32_t failingUnit,
@@ -152,24 +354,35 @@ void SbeDumpCollector::collectSBEDump(uint32_t id, uint32_t failingUnit,
               "PATH", dumpPath.string().c_str(), "ID", id, "FAILINGUNIT",
               failingUnit);
 
-    struct pdbg_target* proc_ody = nullptr;
-    struct pdbg_target* pibFsiTarget = nullptr;
+    SbeDumpTarget sbeTarget;
     std::string sbeChipType;
 
+    std::unique_ptr<TraceRecorder> trace;
+    if (traceEnabled)
+    {
+        trace = std::make_unique<TraceRecorder>();
+    }
+    auto step = [&trace](const char* name) {
+        return std::make_unique<TraceSpan>(trace.get(), "sbe", name);
+    };
+
     try
     {
         // Execute pre-collection steps and get the proc target
-        initializePdbgLibEkb();
-
-        proc_ody = getTargetFromFailingId(failingUnit, sbeTypeId);
+        auto span = step("prepare");
+        sbeTarget = backend->prepareSbeDump(failingUnit, sbeTypeId);
+        if (chipOpRunner.isBusy(sbeTarget.chip))
+        {
+            // The HWPs would reach the SBE while it runs the chip-op
+            throw std::runtime_error(
+                "The SBE is still busy with an abandoned chip-op");
+        }
         if (PROC_SBE_DUMP == sbeTypeId)
         {
-            pibFsiTarget = probeTarget(proc_ody, "pib", sbeTypeId);
             sbeChipType = "_p10_";
         }
         else
         {
-            pibFsiTarget = probeTarget(proc_ody, "fsi", sbeTypeId);
             sbeChipType = "_ody_";
         }
     }
@@ -177,6 +390,7 @@ void SbeDumpCollector::collectSBEDump(uint32_t id, uint32_t failingUnit,
     {
         lg2::error("Failed to collect the SBE dump: {ERROR}", "ERROR",
                    e.what());
+        writeTrace(trace.get(), dumpPath);
         throw;
     }
 
@@ -188,18 +402,30 @@ void SbeDumpCollector::collectSBEDump(uint32_t id, uint32_t failingUnit,
 
     try
     {
-        checkSbeState(pibFsiTarget, sbeTypeId);
+        // Each step is traced until the next one starts
+        auto span = step("checkState");
+        backend->checkSbeState(sbeTarget, sbeTypeId);
 
-        executeSbeExtractRc(proc_ody, dumpPath, sbeTypeId);
+        span = step("extractRc");
+        backend->executeSbeExtractRc(sbeTarget, dumpPath, sbeTypeId);
 
         // Collect various dumps
-        collectLocalRegDump(proc_ody, dumpPath, baseFilename, sbeTypeId);
-        collectPIBMSRegDump(proc_ody, dumpPath, baseFilename, sbeTypeId);
-        collectPIBMEMDump(proc_ody, dumpPath, baseFilename, sbeTypeId);
-        collectPPEState(proc_ody, dumpPath, baseFilename, sbeTypeId);
+        span = step("localReg");
+        backend->collectLocalRegDump(sbeTarget, dumpPath, baseFilename,
+                                     sbeTypeId);
+        span = step("pibms");
+        backend->collectPIBMSRegDump(sbeTarget, dumpPath, baseFilename,
+                                     sbeTypeId);
+        span = step("pibmem");
+        backend->collectPIBMEMDump(sbeTarget, dumpPath, baseFilename,
+                                   sbeTypeId);
+        span = step("ppeState");
+        backend->collectPPEState(sbeTarget, dumpPath, baseFilename, sbeTypeId);
 
         // Finalize the collection process and indicate successful completion
-        finalizeCollection(pibFsiTarget, dumpPath, true, sbeTypeId);
+        span = step("finalize");
+        backend->finalizeSbeDump(sbeTarget, dumpPath, true, sbeTypeId);
+        span.reset();
 
         lg2::info("SBE dump collection completed successfully");
     }
@@ -209,80 +435,322 @@ void SbeDumpCollector::collectSBEDump(uint32_t id, uint32_t failingUnit,
                    e.what());
         // In case of any exception, attempt to finalize with a failure
         // state
-        if (proc_ody)
-            finalizeCollection(pibFsiTarget, dumpPath, false, sbeTypeId);
+        {
+            auto span = step("finalize");
+            backend->finalizeSbeDump(sbeTarget, dumpPath, false, sbeTypeId);
+        }
+        writeTrace(trace.get(), dumpPath);
         throw;
     }
+    writeTrace(trace.get(), dumpPath);
 }
 
-void SbeDumpCollector::initializePdbg()
+void SbeDumpCollector::writeManifest(CollectionState& collection,
+                                     const std::filesystem::path& path)
 {
-    openpower::phal::pdbg::init();
+    nlohmann::json manifest = {{"deadlineMs", nullptr},
+                               {"chipOps", nlohmann::json::array()},
+                               {"abandoned", nlohmann::json::array()}};
+    {
+        std::lock_guard lock(collection.manifestMutex);
+        manifest["chipOps"] = collection.chipOps;
+    }
+    if (collection.deadline)
+    {
+        manifest["deadlineMs"] = toMs(collection.timeAllowed);
+    }
+
+    // The chips whose SBE may still be busy with an abandoned chip-op
+    for (const auto& chipOp : manifest["chipOps"])
+    {
+        if (chipOp["status"] == toString(ChipOpStatus::abandoned))
+        {
+            manifest["abandoned"].push_back(
+                std::format("{}{}", chipOp["chip"].get<std::string>(),
+                            chipOp["position"].get<uint32_t>()));
+        }
+    }
+
+    std::ofstream file(path / "manifest.json");
+    file << manifest.dump(4) << std::endl;
+    if (!file)
+    {
+        lg2::error("Failed to write the dump manifest in {PATH}", "PATH",
+                   path.string());
+    }
 }
 
-std::vector<std::future<void>> SbeDumpCollector::spawnDumpCollectionProcesses(
-    uint8_t type, uint32_t id, const std::filesystem::path& path,
-    uint64_t failingUnit, uint8_t cstate, const TargetMap& targetMap)
+void SbeDumpCollector::writeTrace(const TraceRecorder* trace,
+                                  const std::filesystem::path& path)
 {
-    std::vector<std::future<void>> futures;
+    if (trace == nullptr)
+    {
+        return;
+    }
 
-    for (const auto& [procTarget, ocmbTargets] : targetMap)
+    try
     {
-        auto future = std::async(std::launch::async, [this, procTarget,
-                                                      ocmbTargets, path, id,
-                                                      type, cstate,
-                                                      failingUnit]() {
-            try
-            {
-                this->collectDumpFromSBE(procTarget, path, id, type, cstate,
-                                         failingUnit);
-            }
-            catch (const std::exception& e)
-            {
-                lg2::error(
-                    "Failed to collect dump from SBE on Proc-({PROCINDEX}) {ERROR}",
-                    "PROCINDEX", pdbg_target_index(procTarget), "ERROR", e);
-            }
+        trace->write(path / "trace.json");
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to write the collection trace, {ERROR}", "ERROR",
+                   e);
+    }
+}
+
+/**
+ * @struct SbeDumpCollector::ProcPipeline
+ * @brief Progress of the dump collection from a proc and its OCMBs.
+ */
+struct SbeDumpCollector::ProcPipeline
+{
+    ProcPipeline(const Chip& proc, const ProcTargets& targets,
+                 const std::filesystem::path& path, uint32_t id, uint8_t type,
+                 uint64_t failingUnit, const std::vector<uint8_t>& clockStates,
+                 CollectionState& collection) :
+        proc(proc), targets(targets), path(path), id(id), type(type),
+        failingUnit(failingUnit), clockStates(clockStates),
+        collection(collection), started(targets.ocmbs.size(), false)
+    {
+        std::set<uint32_t> links;
+        for (const auto& ocmb : targets.ocmbs)
+        {
+            links.insert(ocmb.link);
+        }
+        ocmbWidth = std::max<size_t>(
+            std::min(std::max<size_t>(targets.maxOcmbsPerProc, 1),
+                     links.size() * std::max<size_t>(targets.maxOcmbsPerLink,
+                                                     1)),
+            1);
+    }
+
+    const Chip proc;
+    const ProcTargets targets;
+    const std::filesystem::path path;
+    const uint32_t id;
+    const uint8_t type;
+    const uint64_t failingUnit;
+    const std::vector<uint8_t> clockStates;
+
+    /** @brief State of the running collection */
+    CollectionState& collection;
+
+    /** @brief Protects the OCMB progress below */
+    std::mutex mutex;
+
+    /** @brief Clock state to resume the proc at once the OCMBs are done */
+    size_t resumeState = 0;
 
-            // Collect OCMBs only with clock on
-            if (cstate == SBE_CLOCK_ON)
+    /** @brief OCMBs whose collection is started */
+    std::vector<bool> started;
+
+    /** @brief OCMB chip-ops in flight on the proc */
+    size_t inFlight = 0;
+
+    /** @brief OCMB chip-ops in flight on each FSI link */
+    std::map<uint32_t, size_t> inFlightPerLink;
+
+    /** @brief OCMBs whose collection is completed */
+    size_t completed = 0;
+
+    /** @brief OCMB chip-ops in flight at most, as allowed by the limits */
+    size_t ocmbWidth = 1;
+
+    /**
+     * @brief Returns the chip-ops left to run one after the other, counting
+     * each wave of OCMB chip-ops in flight together as one.
+     *
+     * @param state - Index of the next clock state of the proc
+     * @param ocmbsLeft - OCMBs not collected yet
+     */
+    size_t stepsLeft(size_t state, size_t ocmbsLeft) const
+    {
+        return clockStates.size() - state +
+               (ocmbsLeft + ocmbWidth - 1) / ocmbWidth;
+    }
+};
+
+size_t SbeDumpCollector::defaultWorkerCount()
+{
+    // Chip-ops spend nearly all their time waiting for the SBE, so the pool
+    // keeps a few chip-ops in flight per core.
+    constexpr size_t chipOpsPerCore = 4;
+    return std::max(std::thread::hardware_concurrency(), 1U) * chipOpsPerCore;
+}
+
+void SbeDumpCollector::runProcPipeline(
+    WorkerPool& pool, const std::shared_ptr<ProcPipeline>& pipeline,
+    size_t state)
+{
+    const auto& procTarget = pipeline->proc;
+    auto& collection = pipeline->collection;
+    for (; state < pipeline->clockStates.size(); state++)
+    {
+        auto cstate = pipeline->clockStates[state];
+        // The OCMBs are collected after the clock on state
+        auto ocmbsLeft =
+            (cstate == SBE_CLOCK_ON) ? pipeline->targets.ocmbs.size() : 0;
+        auto limit =
+            collection.chipOpLimit(pipeline->stepsLeft(state, ocmbsLeft));
+        try
+        {
+            collectDumpFromSBE(procTarget, pipeline->path, pipeline->id,
+                               pipeline->type, cstate, pipeline->failingUnit,
+                               collection, limit);
+        }
+        catch (const std::exception& e)
+        {
+            lg2::error("Failed to collect dump from SBE on "
+                       "Proc-({PROCINDEX}) {ERROR}",
+                       "PROCINDEX", procTarget.position, "ERROR", e);
+        }
+
+        // Collect OCMBs only with clock on, the proc continues with the
+        // next clock state after the last OCMB
+        if (cstate == SBE_CLOCK_ON && !pipeline->targets.ocmbs.empty())
+        {
             {
-                // Handle OCMBs serially after handling the proc
-                for (auto ocmbTarget : ocmbTargets)
-                {
-                    try
-                    {
-                        this->collectDumpFromSBE(ocmbTarget, path, id, type,
-                                                 cstate, failingUnit);
-                    }
-                    catch (const std::exception& e)
-                    {
-                        lg2::error(
-                            "Failed to collect dump from OCMB -({OCMBINDEX}) {ERROR}",
-                            "OCMBINDEX", pdbg_target_index(ocmbTarget), "ERROR",
-                            e);
-                    }
-                }
+                std::lock_guard lock(pipeline->mutex);
+                pipeline->resumeState = state + 1;
             }
+            dispatchOcmbDumps(pool, pipeline);
+            return;
+        }
+    }
+    lg2::info("Dump collection completed for proc({PROCINDEX}): "
+              "type({TYPE}) id({ID}) failingUnit({FAILINGUNIT})",
+              "PROCINDEX", procTarget.position, "TYPE", pipeline->type, "ID",
+              pipeline->id, "FAILINGUNIT", pipeline->failingUnit);
+}
+
+void SbeDumpCollector::dispatchOcmbDumps(
+    WorkerPool& pool, const std::shared_ptr<ProcPipeline>& pipeline)
+{
+    const auto& ocmbs = pipeline->targets.ocmbs;
+    auto maxPerProc = std::max<size_t>(pipeline->targets.maxOcmbsPerProc, 1);
+    auto maxPerLink = std::max<size_t>(pipeline->targets.maxOcmbsPerLink, 1);
+
+    std::lock_guard lock(pipeline->mutex);
+    for (size_t i = 0; i < ocmbs.size() && pipeline->inFlight < maxPerProc;
+         i++)
+    {
+        if (pipeline->started[i] ||
+            pipeline->inFlightPerLink[ocmbs[i].link] >= maxPerLink)
+        {
+            continue;
+        }
+        pipeline->started[i] = true;
+        pipeline->inFlight++;
+        pipeline->inFlightPerLink[ocmbs[i].link]++;
+
+        pool.submit([this, &pool, pipeline, i]() {
+            collectOcmbDump(pool, pipeline, i);
         });
+    }
+}
+
+void SbeDumpCollector::collectOcmbDump(
+    WorkerPool& pool, const std::shared_ptr<ProcPipeline>& pipeline,
+    size_t index)
+{
+    const auto& ocmbTarget = pipeline->targets.ocmbs[index];
+
+    ChipOpLimit limit;
+    {
+        std::lock_guard lock(pipeline->mutex);
+        limit = pipeline->collection.chipOpLimit(pipeline->stepsLeft(
+            pipeline->resumeState,
+            pipeline->targets.ocmbs.size() - pipeline->completed));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    try
+    {
+        collectDumpFromSBE(ocmbTarget, pipeline->path, pipeline->id,
+                           pipeline->type, SBE_CLOCK_ON,
+                           pipeline->failingUnit, pipeline->collection, limit);
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to collect dump from OCMB -({OCMBINDEX}) {ERROR}",
+                   "OCMBINDEX", ocmbTarget.position, "ERROR", e);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    lg2::info("Dump collection from OCMB({OCMBINDEX}) on link({LINK}) "
+              "took {ELAPSED}ms",
+              "OCMBINDEX", ocmbTarget.position, "LINK", ocmbTarget.link,
+              "ELAPSED", elapsed.count());
 
-        futures.push_back(std::move(future));
+    size_t resumeState = 0;
+    bool lastOcmb = false;
+    {
+        std::lock_guard lock(pipeline->mutex);
+        pipeline->inFlight--;
+        pipeline->inFlightPerLink[ocmbTarget.link]--;
+        lastOcmb = (++pipeline->completed == pipeline->targets.ocmbs.size());
+        resumeState = pipeline->resumeState;
     }
 
-    return futures;
+    if (lastOcmb)
+    {
+        runProcPipeline(pool, pipeline, resumeState);
+    }
+    else
+    {
+        dispatchOcmbDumps(pool, pipeline);
+    }
+}
+
+void SbeDumpCollector::reportError(std::exception_ptr error, uint64_t chipPos,
+                                   SBETypes sbeType, uint32_t cmdClass,
+                                   uint32_t cmdType,
+                                   const std::filesystem::path& path,
+                                   CollectionState& collection)
+{
+    if (!error)
+    {
+        return;
+    }
+    collection.reporter.submit(
+        [this, error, chipPos, sbeType, cmdClass, cmdType, path,
+         &collection]() {
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (const openpower::phal::sbeError_t& sbeError)
+            {
+                PhaseTimer timer(collection.timing, TimingPhase::pelCreation);
+                TraceSpan span(collection.trace.get(), "ffdc",
+                               std::format("{}{} PEL",
+                                           sbeTypeAttributes.at(sbeType)
+                                               .chipName,
+                                           chipPos),
+                               {{"cmdClass", cmdClass}, {"cmdType", cmdType}});
+                openpower::dump::pel::PELBatch batch;
+                logErrorAndCreatePEL(sbeError, chipPos, sbeType, cmdClass,
+                                     cmdType, path, batch,
+                                     collection.nestedDumps);
+                addBatchLogsToDump(batch,
+                                   sbeTypeAttributes.at(sbeType).chipName,
+                                   chipPos, path);
+            }
+        });
 }
 
-bool SbeDumpCollector::logErrorAndCreatePEL(
+void SbeDumpCollector::logErrorAndCreatePEL(
     const openpower::phal::sbeError_t& sbeError, uint64_t chipPos,
     SBETypes sbeType, uint32_t cmdClass, uint32_t cmdType,
-    const std::filesystem::path& path)
+    const std::filesystem::path& path, openpower::dump::pel::PELBatch& batch,
+    std::vector<std::string>& nestedDumps)
 {
     namespace fs = std::filesystem;
 
     std::string chipName;
     std::string event;
     bool dumpIsRequired = false;
-    bool isDumpFailure = true;
     try
     {
         chipName = sbeTypeAttributes.at(sbeType).chipName;
@@ -326,31 +794,16 @@ bool SbeDumpCollector::logErrorAndCreatePEL(
                     "FFDC Not related to chip-op present {CHIP} {POSITION}",
                     "CHIP", chipName, "POSITION", chipPos);
                 event = sbeTypeAttributes.at(sbeType).sbeInternalFFDCData;
-                isDumpFailure = false;
             }
             else
             {
                 lg2::error("Process FFDC {CHIP} {POSITION}", "CHIP", chipName,
                            "POSITION", chipPos);
             }
-            // Processor FFDC Packets
-            std::vector<uint32_t> logIdList =
-                openpower::dump::pel::processFFDCPackets(sbeError, event,
-                                                         pelAdditionalData);
-            for (auto logId : logIdList)
-            {
-                try
-                {
-                    auto logInfo = openpower::dump::pel::getLogInfo(logId);
-                    addLogDataToDump(std::get<0>(logInfo), std::get<1>(logInfo),
-                                     chipName, chipPos, path.parent_path());
-                }
-                catch (const std::exception& e)
-                {
-                    lg2::error("Failed to get error Info: {ERROR} ", "ERROR",
-                               e);
-                }
-            }
+            // Processor FFDC Packets, the PELs are created while the caller
+            // goes on with the dump
+            openpower::dump::pel::processFFDCPackets(sbeError, event,
+                                                     pelAdditionalData, batch);
         }
 
         // If dump is required, request it
@@ -363,7 +816,14 @@ bool SbeDumpCollector::logErrorAndCreatePEL(
                 auto logInfo = openpower::dump::pel::getLogInfo(logId);
                 addLogDataToDump(std::get<0>(logInfo), std::get<1>(logInfo),
                                  chipName, chipPos, path.parent_path());
-                util::requestSBEDump(chipPos, std::get<0>(logInfo), sbeType);
+                // The nested dump runs on its own, it is only followed up
+                // once the collection is over
+                auto dumpPath = util::createSBEDump(
+                    chipPos, std::get<0>(logInfo), sbeType);
+                if (!dumpPath.empty())
+                {
+                    nestedDumps.push_back(dumpPath);
+                }
             }
             catch (const std::exception& e)
             {
@@ -384,16 +844,15 @@ bool SbeDumpCollector::logErrorAndCreatePEL(
                    "position({CHIPPOS}), Error: {ERROR}",
                    "CHIPTYPE", chipName, "CHIPPOS", chipPos, "ERROR", e);
     }
-
-    return isDumpFailure;
 }
 
-void SbeDumpCollector::collectDumpFromSBE(
-    struct pdbg_target* chip, const std::filesystem::path& path, uint32_t id,
-    uint8_t type, uint8_t clockState, uint64_t failingUnit)
+ChipOpStatus SbeDumpCollector::collectDumpFromSBE(
+    const Chip& chip, const std::filesystem::path& path, uint32_t id,
+    uint8_t type, uint8_t clockState, uint64_t failingUnit,
+    CollectionState& collection, const ChipOpLimit& limit)
 {
-    auto chipPos = pdbg_target_index(chip);
-    SBETypes sbeType = getSBEType(chip);
+    auto chipPos = chip.position;
+    SBETypes sbeType = chip.sbeType;
     auto chipName = sbeTypeAttributes.at(sbeType).chipName;
     lg2::info(
         "Collecting dump from ({CHIPTYPE}) ({POSITION}): path({PATH}) id({ID}) "
@@ -401,18 +860,116 @@ void SbeDumpCollector::collectDumpFromSBE(
         "CHIPTYPE", chipName, "POSITION", chipPos, "PATH", path.string(), "ID",
         id, "TYPE", type, "CLOCKSTATE", clockState, "FAILINGUNIT", failingUnit);
 
-    util::DumpDataPtr dataPtr;
-    uint32_t len = 0;
     uint8_t collectFastArray =
         checkFastarrayCollectionNeeded(clockState, type, failingUnit, chipPos);
 
+    using Clock = CollectionTiming::Clock;
+    nlohmann::json manifest = {{"op", "getDump"},
+                               {"clockState", clockStateName(clockState)}};
+    if (chipOpRunner.isBusy(chip))
+    {
+        lg2::error("({CHIPTYPE}) ({POSITION}) is still busy with an abandoned "
+                   "chip-op, skipping clockState({CLOCKSTATE})",
+                   "CHIPTYPE", chipName, "POSITION", chipPos, "CLOCKSTATE",
+                   clockState);
+        manifest["error"] = "busy with an abandoned chip-op";
+        collection.record(chip, std::move(manifest), ChipOpStatus::skipped);
+        return ChipOpStatus::skipped;
+    }
+    if (limit)
+    {
+        manifest["budgetMs"] = std::max<int64_t>(toMs(*limit - Clock::now()),
+                                                 0);
+        if (Clock::now() >= *limit)
+        {
+            lg2::error("Dump deadline reached, skipping ({CHIPTYPE}) "
+                       "({POSITION}) clockState({CLOCKSTATE})",
+                       "CHIPTYPE", chipName, "POSITION", chipPos,
+                       "CLOCKSTATE", clockState);
+            collection.record(chip, std::move(manifest),
+                              ChipOpStatus::skipped);
+            return ChipOpStatus::skipped;
+        }
+    }
+
+    auto* trace = collection.trace.get();
+    TraceSpan chipOpSpan(
+        trace, "chipop",
+        std::format("{}{} clocks {}", chipName, chipPos,
+                    clockState == SBE_CLOCK_ON ? "on" : "off"),
+        {{"type", type}, {"fastArray", collectFastArray}});
+
+    // The dump data is written to the file as it arrives from the SBE, the
+    // file is discarded unless the chip-op provides a usable dump.
+    auto dumpFile = createDumpFile(path, id, clockState, 0, chipName, chipPos);
+
+    // The chip-op latency leaves out the writes done as the data arrives
+    auto chipOpStart = Clock::now();
+    Clock::duration writeTime{};
+    auto recordChipOp = [&]() {
+        auto elapsed = Clock::now() - chipOpStart;
+        collection.timing.recordChipOp(sbeType, chipPos, elapsed - writeTime);
+        manifest["elapsedMs"] = toMs(elapsed);
+    };
+    auto writeData = [this, &dumpFile, &writeTime, trace](const uint8_t* data,
+                                                          size_t len) {
+        auto writeStart = Clock::now();
+        TraceSpan span(trace, "file", "write", {{"bytes", len}});
+        writeDumpData(dumpFile, data, len);
+        writeTime += Clock::now() - writeStart;
+    };
+
+    // An abandoned chip-op may outlive this call, it only reaches the dump
+    // file through the caller link
+    auto chipOp = [backend = backend, chip, type, clockState, collectFastArray,
+                   &writeData](const ChipOpCaller& caller) {
+        auto handler = [&caller, &writeData](const uint8_t* data, size_t len) {
+            caller.call([&]() { writeData(data, len); });
+        };
+        backend->getDump(chip, type, clockState, collectFastArray, handler);
+    };
+
     try
     {
-        openpower::phal::sbe::getDump(chip, type, clockState, collectFastArray,
-                                      dataPtr.getPtr(), &len);
+        auto run = chipOpRunner.run(
+            chip,
+            std::format("getDump {}{} clockState {}", chipName, chipPos,
+                        clockState),
+            limit, chipOp);
+        if (run == ChipOpRun::notStarted)
+        {
+            chipOpSpan.arg("notStarted", true);
+            lg2::error("Skipped the dump of ({CHIPTYPE}) ({POSITION}) "
+                       "clockState({CLOCKSTATE}), no chip-op helper was free "
+                       "within its budget of {BUDGET}ms",
+                       "CHIPTYPE", chipName, "POSITION", chipPos,
+                       "CLOCKSTATE", clockState, "BUDGET",
+                       manifest["budgetMs"].get<int64_t>());
+            manifest["error"] = "no chip-op helper free within the budget";
+            collection.record(chip, std::move(manifest),
+                              ChipOpStatus::skipped);
+            return ChipOpStatus::skipped;
+        }
+        recordChipOp();
+        if (run == ChipOpRun::abandoned)
+        {
+            chipOpSpan.arg("abandoned", true);
+            lg2::error("Abandoned the dump of ({CHIPTYPE}) ({POSITION}) "
+                       "clockState({CLOCKSTATE}), the chip-op overran its "
+                       "budget of {BUDGET}ms",
+                       "CHIPTYPE", chipName, "POSITION", chipPos,
+                       "CLOCKSTATE", clockState, "BUDGET",
+                       manifest["budgetMs"].get<int64_t>());
+            collection.record(chip, std::move(manifest),
+                              ChipOpStatus::abandoned);
+            return ChipOpStatus::abandoned;
+        }
     }
     catch (const openpower::phal::sbeError_t& sbeError)
     {
+        recordChipOp();
+        chipOpSpan.arg("error", sbeError.what());
+        manifest["error"] = sbeError.what();
         if (sbeError.errType() ==
             openpower::phal::exception::SBE_CHIPOP_NOT_ALLOWED)
         {
@@ -422,16 +979,19 @@ void SbeDumpCollector::collectDumpFromSBE(
                       "on proc({PROC}) clock state({CLOCKSTATE})",
                       "ERROR", sbeError, "TYPE", type, "PROC", chipPos,
                       "CLOCKSTATE", clockState);
-            return;
+            collection.record(chip, std::move(manifest),
+                              ChipOpStatus::skipped);
+            return ChipOpStatus::skipped;
         }
 
-        // If the FFDC is from actual chip-op failure this function will
-        // return true, if the chip-op is not failed but FFDC is present
-        // then create PELs with FFDC but write the dump contents to the
-        // file.
-        if (logErrorAndCreatePEL(sbeError, chipPos, sbeType,
-                                 SBEFIFO_CMD_CLASS_DUMP, SBEFIFO_CMD_GET_DUMP,
-                                 path))
+        // The PELs are created by the error reporter. If the FFDC is not
+        // related to the chip-op, the chip-op did not fail and the dump
+        // contents are still written to the file.
+        reportError(std::current_exception(), chipPos, sbeType,
+                    SBEFIFO_CMD_CLASS_DUMP, SBEFIFO_CMD_GET_DUMP, path,
+                    collection);
+        if (sbeError.errType() !=
+            openpower::phal::exception::SBE_INTERNAL_FFDC_DATA)
         {
             lg2::error("Error in collecting dump dump type({TYPE}), "
                        "clockstate({CLOCKSTATE}), chip type({CHIPTYPE}) "
@@ -440,17 +1000,26 @@ void SbeDumpCollector::collectDumpFromSBE(
                        "TYPE", type, "CLOCKSTATE", clockState, "CHIPTYPE",
                        chipName, "POSITION", chipPos, "COLLECTFASTARRAY",
                        collectFastArray, "ERROR", sbeError);
-            return;
+            collection.record(chip, std::move(manifest), ChipOpStatus::failed);
+            return ChipOpStatus::failed;
         }
     }
-    writeDumpFile(path, id, clockState, 0, chipName, chipPos, dataPtr, len);
+
+    auto commitStart = Clock::now();
+    {
+        TraceSpan span(trace, "file", "commit");
+        commitDumpFile(dumpFile);
+    }
+    collection.timing.record(TimingPhase::fileWrite,
+                             writeTime + (Clock::now() - commitStart));
+    collection.record(chip, std::move(manifest), ChipOpStatus::collected);
+    return ChipOpStatus::collected;
 }
 
-void SbeDumpCollector::writeDumpFile(
+std::unique_ptr<DumpFile> SbeDumpCollector::createDumpFile(
     const std::filesystem::path& path, const uint32_t id,
     const uint8_t clockState, const uint8_t nodeNum,
-    const std::string& chipName, const uint8_t chipPos,
-    util::DumpDataPtr& dataPtr, const uint32_t len)
+    const std::string& chipName, const uint8_t chipPos)
 {
     using namespace sdbusplus::xyz::openbmc_project::Common::Error;
     namespace fileError = sdbusplus::xyz::openbmc_project::Common::File::Error;
@@ -466,13 +1035,16 @@ void SbeDumpCollector::writeDumpFile(
     auto dumpPath = path / filenameBuilder.str();
 
     // Attempt to open the file
-    std::ofstream outfile(dumpPath, std::ios::out | std::ios::binary);
-    if (!outfile)
+    try
+    {
+        return std::make_unique<DumpFile>(dumpPath, dumpCompression);
+    }
+    catch (const std::system_error& e)
     {
         using namespace sdbusplus::xyz::openbmc_project::Common::File::Error;
         using metadata = xyz::openbmc_project::Common::File::Open;
         // Unable to open the file for writing
-        auto err = errno;
+        auto err = e.code().value();
         lg2::error("Error opening file to write dump, "
                    "errno({ERRNO}), filepath({FILEPATH})",
                    "ERRNO", err, "FILEPATH", dumpPath.string());
@@ -480,62 +1052,163 @@ void SbeDumpCollector::writeDumpFile(
         report<Open>(metadata::ERRNO(err), metadata::PATH(dumpPath.c_str()));
         // Just return here, so that the dumps collected from other
         // SBEs can be packaged.
+        return nullptr;
+    }
+}
+
+void SbeDumpCollector::writeDumpData(std::unique_ptr<DumpFile>& dumpFile,
+                                     const uint8_t* data, size_t len)
+{
+    if (!dumpFile)
+    {
         return;
     }
 
-    // Write to the file
     try
     {
-        outfile.write(reinterpret_cast<const char*>(dataPtr.getData()), len);
+        dumpFile->write(data, len);
+    }
+    catch (const std::system_error& e)
+    {
+        reportDumpWriteFailure(*dumpFile, e);
+        // Drop the rest of the data for this chip so that the dumps
+        // collected from other SBEs can be packaged.
+        dumpFile.reset();
+    }
+}
+
+void SbeDumpCollector::commitDumpFile(std::unique_ptr<DumpFile>& dumpFile)
+{
+    if (!dumpFile)
+    {
+        return;
+    }
+
+    try
+    {
+        dumpFile->commit();
 
         lg2::info("Successfully wrote dump file "
-                  "path=({PATH}) size=({SIZE})",
-                  "PATH", dumpPath.string(), "SIZE", len);
+                  "path=({PATH}) size=({SIZE}) stored=({STORED})",
+                  "PATH", dumpFile->getPath().string(), "SIZE",
+                  dumpFile->size(), "STORED", dumpFile->storedSize());
     }
-    catch (const std::ofstream::failure& oe)
+    catch (const std::system_error& e)
     {
-        using namespace sdbusplus::xyz::openbmc_project::Common::File::Error;
-        using metadata = xyz::openbmc_project::Common::File::Write;
-
-        lg2::error(
-            "Failed to write to dump file, "
-            "errorMsg({ERROR}), error({ERRORCODE}), filepath({FILEPATH})",
-            "ERROR", oe, "ERRORCODE", oe.code().value(), "FILEPATH",
-            dumpPath.string());
-        report<Write>(metadata::ERRNO(oe.code().value()),
-                      metadata::PATH(dumpPath.c_str()));
-        // Just return here so dumps collected from other SBEs can be
-        // packaged.
+        reportDumpWriteFailure(*dumpFile, e);
     }
+    dumpFile.reset();
+}
+
+void SbeDumpCollector::reportDumpWriteFailure(const DumpFile& dumpFile,
+                                              const std::system_error& e)
+{
+    using namespace sdbusplus::xyz::openbmc_project::Common::File::Error;
+    using metadata = xyz::openbmc_project::Common::File::Write;
+
+    lg2::error("Failed to write to dump file, "
+               "errorMsg({ERROR}), error({ERRORCODE}), filepath({FILEPATH})",
+               "ERROR", e, "ERRORCODE", e.code().value(), "FILEPATH",
+               dumpFile.getPath().string());
+    report<Write>(metadata::ERRNO(e.code().value()),
+                  metadata::PATH(dumpFile.getPath().c_str()));
 }
 
-bool SbeDumpCollector::executeThreadStop(struct pdbg_target* target,
-                                         const std::filesystem::path& path)
+bool SbeDumpCollector::executeThreadStop(const Chip& target,
+                                         const std::filesystem::path& path,
+                                         CollectionState& collection,
+                                         const ChipOpLimit& limit)
 {
+    using Clock = CollectionTiming::Clock;
+    nlohmann::json manifest = {{"op", "threadStop"}};
+    if (chipOpRunner.isBusy(target))
+    {
+        lg2::error("Proc-({POSITION}) is still busy with an abandoned "
+                   "chip-op, skipping the stop instructions",
+                   "POSITION", target.position);
+        manifest["error"] = "busy with an abandoned chip-op";
+        collection.record(target, std::move(manifest), ChipOpStatus::skipped);
+        return false;
+    }
+    if (limit)
+    {
+        manifest["budgetMs"] = std::max<int64_t>(toMs(*limit - Clock::now()),
+                                                 0);
+        if (Clock::now() >= *limit)
+        {
+            lg2::error("Dump deadline reached, skipping the stop "
+                       "instructions on proc-({POSITION})",
+                       "POSITION", target.position);
+            collection.record(target, std::move(manifest),
+                              ChipOpStatus::skipped);
+            return false;
+        }
+    }
+
+    auto start = Clock::now();
     try
     {
-        openpower::phal::sbe::threadStopProc(target);
+        PhaseTimer timer(collection.timing, TimingPhase::threadStop);
+        TraceSpan span(collection.trace.get(), "threadStop",
+                       std::format("proc{}", target.position));
+        auto run = chipOpRunner.run(
+            target, std::format("threadStop proc{}", target.position), limit,
+            [backend = backend, target](const ChipOpCaller&) {
+                backend->threadStop(target);
+            });
+        if (run == ChipOpRun::notStarted)
+        {
+            span.arg("notStarted", true);
+            lg2::error("Skipped the stop instructions on proc-({POSITION}), "
+                       "no chip-op helper was free within its budget of "
+                       "{BUDGET}ms",
+                       "POSITION", target.position, "BUDGET",
+                       manifest["budgetMs"].get<int64_t>());
+            manifest["error"] = "no chip-op helper free within the budget";
+            collection.record(target, std::move(manifest),
+                              ChipOpStatus::skipped);
+            return false;
+        }
+        manifest["elapsedMs"] = toMs(Clock::now() - start);
+        if (run == ChipOpRun::abandoned)
+        {
+            span.arg("abandoned", true);
+            lg2::error("Abandoned the stop instructions on proc-({POSITION}), "
+                       "the chip-op overran its budget of {BUDGET}ms",
+                       "POSITION", target.position, "BUDGET",
+                       manifest["budgetMs"].get<int64_t>());
+            collection.record(target, std::move(manifest),
+                              ChipOpStatus::abandoned);
+            return false;
+        }
+        collection.record(target, std::move(manifest),
+                          ChipOpStatus::collected);
         return true;
     }
     catch (const openpower::phal::sbeError_t& sbeError)
     {
-        uint64_t chipPos = pdbg_target_index(target);
+        uint64_t chipPos = target.position;
+        manifest["elapsedMs"] = toMs(Clock::now() - start);
+        manifest["error"] = sbeError.what();
         if (sbeError.errType() ==
             openpower::phal::exception::SBE_CHIPOP_NOT_ALLOWED)
         {
             lg2::info("SBE is not ready to accept chip-op: Skipping "
                       "stop instruction on proc-({POSITION}) error({ERROR}) ",
                       "POSITION", chipPos, "ERROR", sbeError);
+            collection.record(target, std::move(manifest),
+                              ChipOpStatus::skipped);
             return false; // Do not include the target for dump collection
         }
 
         lg2::error("Stop instructions failed on "
                    "proc-({POSITION}) error({ERROR}) ",
                    "POSITION", chipPos, "ERROR", sbeError);
+        collection.record(target, std::move(manifest), ChipOpStatus::failed);
 
-        logErrorAndCreatePEL(sbeError, chipPos, SBETypes::PROC,
-                             SBEFIFO_CMD_CLASS_INSTRUCTION,
-                             SBEFIFO_CMD_CONTROL_INSN, path);
+        reportError(std::current_exception(), chipPos, SBETypes::PROC,
+                    SBEFIFO_CMD_CLASS_INSTRUCTION, SBEFIFO_CMD_CONTROL_INSN,
+                    path, collection);
         // For TIMEOUT, log the error and skip adding the processor for dump
         // collection
         if (sbeError.errType() == openpower::phal::exception::SBE_CMD_TIMEOUT)
@@ -548,6 +1221,25 @@ bool SbeDumpCollector::executeThreadStop(struct pdbg_target* target,
     return true;
 }
 
+void SbeDumpCollector::addBatchLogsToDump(
+    openpower::dump::pel::PELBatch& batch, const std::string& chipName,
+    uint64_t chipPos, const std::filesystem::path& path)
+{
+    try
+    {
+        auto logInfos = openpower::dump::pel::getLogInfos(batch.wait());
+        for (const auto& [logId, logInfo] : logInfos)
+        {
+            addLogDataToDump(std::get<0>(logInfo), std::get<1>(logInfo),
+                             chipName, chipPos, path.parent_path());
+        }
+    }
+    catch (const std::exception& e)
+    {
+        lg2::error("Failed to get error Info: {ERROR} ", "ERROR", e);
+    }
+}
+
 void SbeDumpCollector::addLogDataToDump(uint32_t pelId, std::string src,
                                         std::string chipName, uint64_t chipPos,
                                         const std::filesystem::path& path)
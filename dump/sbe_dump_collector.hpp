@@ -1,27 +1,63 @@
 #pragma once
 
-extern "C"
-{
-#include <libpdbg.h>
-#include <libpdbg_sbe.h>
-}
-
+#include "chipop_backend.hpp"
+#include "chipop_deadline.hpp"
+#include "collection_timing.hpp"
+#include "create_pel.hpp"
+#include "dump_file.hpp"
 #include "dump_utils.hpp"
 #include "sbe_consts.hpp"
 #include "sbe_type.hpp"
+#include "trace_recorder.hpp"
+#include "worker_pool.hpp"
 
 #include <phal_exception.H>
 
+#include <chrono>
 #include <cstdint>
+#include <exception>
 #include <filesystem>
-#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
 #include <vector>
 
 namespace openpower::dump::sbe_chipop
 {
 
-using TargetMap =
-    std::map<struct pdbg_target*, std::vector<struct pdbg_target*>>;
+/**
+ * @struct OcmbConcurrency
+ * @brief Limits on the OCMB dumps collected at the same time.
+ */
+struct OcmbConcurrency
+{
+    /** @brief Maximum OCMB dumps in flight on each proc */
+    size_t perProc = 4;
+
+    /** @brief Maximum OCMB dumps in flight on each FSI link */
+    size_t perLink = 1;
+};
+
+/**
+ * @brief Outcome of a chip-op, as recorded in the manifest of the dump.
+ */
+enum class ChipOpStatus
+{
+    /** @brief The chip-op completed */
+    collected,
+
+    /** @brief The chip-op failed */
+    failed,
+
+    /** @brief The chip-op was not run: the SBE does not accept chip-ops, it
+     * is still busy with an abandoned chip-op, the deadline is reached or no
+     * helper thread was free before the budget ran out */
+    skipped,
+
+    /** @brief The chip-op overran its budget and was not waited for */
+    abandoned
+};
 
 /**
  * @class SbeDumpCollector
@@ -34,10 +70,20 @@ using TargetMap =
 class SbeDumpCollector
 {
   public:
+    /**
+     * @brief Constructs a new SbeDumpCollector object collecting the dumps
+     * from the hardware through the PHAL libraries.
+     */
+    SbeDumpCollector();
+
     /**
      * @brief Constructs a new SbeDumpCollector object.
+     *
+     * @param backend The chip-op backend used to collect the dumps.
      */
-    SbeDumpCollector() = default;
+    explicit SbeDumpCollector(std::unique_ptr<ChipOpBackend> backend) :
+        backend(std::move(backend))
+    {}
 
     /**
      * @brief Destroys the SbeDumpCollector object.
@@ -56,11 +102,128 @@ class SbeDumpCollector
      * @param failingUnit ID of the failing unit from which the dump is
      * collected.
      * @param path Path where the collected dump will be stored.
+     * @param deadline Time allowed for a Hardware/Hostboot dump, 0 for no
+     * limit. It is split into budgets for the chip-ops, a chip-op overrunning
+     * its budget is abandoned, and the chips not reached in time are
+     * skipped. A chip running an abandoned chip-op is skipped until the
+     * chip-op completes, by this collection and the later ones. The
+     * collection then returns within the deadline, plus the time taken to
+     * log the chip-op failures.
      */
     void collectDump(uint8_t type, uint32_t id, uint32_t failingUnit,
-                     const std::filesystem::path& path);
+                     const std::filesystem::path& path,
+                     std::chrono::seconds deadline = std::chrono::seconds{0});
+
+    /**
+     * @brief Initializes the backend ahead of the first collection.
+     *
+     * A long-running collector calls it once at startup, the collections
+     * then start their chip-ops without loading the device tree or libekb.
+     */
+    void initialize();
+
+    /**
+     * @brief Sets how many OCMB dumps are collected at the same time.
+     *
+     * @param limits The limits per proc and per FSI link.
+     */
+    void setOcmbConcurrency(const OcmbConcurrency& limits)
+    {
+        ocmbConcurrency = limits;
+    }
+
+    /**
+     * @brief Sets the number of worker threads collecting the dumps, which
+     * also bounds the chip-ops run with a deadline at once.
+     *
+     * @param workers The number of workers, 0 to size the pool from the
+     * number of cores.
+     */
+    void setWorkerCount(size_t workers)
+    {
+        workerCount = workers;
+        chipOpRunner.setMaxHelpers(workers != 0 ? workers
+                                                : defaultWorkerCount());
+    }
+
+    /**
+     * @brief Sets the compression applied to the dump files as they are
+     * written.
+     *
+     * @param compression The compression of the dump files.
+     */
+    void setCompression(DumpCompression compression)
+    {
+        dumpCompression = compression;
+    }
+
+    /**
+     * @brief Sets how long the end of a collection waits for the SBE dumps
+     * requested by its chip-op timeouts.
+     *
+     * @param timeout The longest wait, 0 to only log the requested dumps.
+     */
+    void setNestedDumpWait(std::chrono::seconds timeout)
+    {
+        nestedDumpWait = timeout;
+    }
+
+    /**
+     * @brief Enables the trace of the collections.
+     *
+     * The steps run by each thread are written in the trace.json of the
+     * dump, in the Chrome trace event format.
+     *
+     * @param enabled Whether the collections are traced.
+     */
+    void setTrace(bool enabled)
+    {
+        traceEnabled = enabled;
+    }
+
+    /**
+     * @brief Returns the latencies of the last hardware or hostboot dump
+     * collected, also written in its timing.json.
+     */
+    TimingSummary lastTiming() const
+    {
+        std::lock_guard lock(timingMutex);
+        return lastTimingSummary;
+    }
 
   private:
+    /** @brief Backend servicing the target discovery and chip-ops, shared
+     * with the abandoned chip-ops still running */
+    std::shared_ptr<ChipOpBackend> backend;
+
+    /** @brief Runs the chip-ops with a limit and tracks the chips still busy
+     * with an abandoned chip-op, across the collections */
+    ChipOpRunner chipOpRunner{defaultWorkerCount()};
+
+    /** @brief Limits on the OCMB dumps collected at the same time */
+    OcmbConcurrency ocmbConcurrency;
+
+    /** @brief Number of worker threads, 0 to size from the cores */
+    size_t workerCount = 0;
+
+    /** @brief Compression applied to the dump files */
+    DumpCompression dumpCompression = DumpCompression::none;
+
+    /** @brief Longest wait for the SBE dumps requested meanwhile */
+    std::chrono::seconds nestedDumpWait{0};
+
+    /** @brief Whether the collections write a trace.json */
+    bool traceEnabled = false;
+
+    /** @brief Protects lastTimingSummary */
+    mutable std::mutex timingMutex;
+
+    /** @brief Latencies of the last collection */
+    TimingSummary lastTimingSummary;
+
+    /** @brief Timings, errors and requested dumps of a running collection */
+    struct CollectionState;
+
     /**
      * @brief Orchestrates the collection of dumps from all available SBEs.
      *
@@ -73,9 +236,11 @@ class SbeDumpCollector
      * @param failingUnit The identifier of the failing unit prompting the dump
      * collection.
      * @param path The filesystem path where collected dumps should be stored.
+     * @param deadline Time allowed for the collection, 0 for no limit.
      */
     void collectHWHBDump(uint8_t type, uint32_t id, uint64_t failingUnit,
-                         const std::filesystem::path& path);
+                         const std::filesystem::path& path,
+                         std::chrono::seconds deadline);
 
     /**
      * @brief Execute HWPs to collect SBE dump.
@@ -98,77 +263,121 @@ class SbeDumpCollector
      * Executes the low-level operations required to collect a diagnostic
      * dump from the specified SBE.
      *
-     * @param chip A pointer to the pdbg_target structure representing the SBE.
+     * @param chip The chip containing the SBE.
      * @param path The filesystem path where the dump should be stored.
      * @param id The unique identifier for this dump collection operation.
      * @param type The type of dump to collect.
      * @param clockState The clock state of the SBE during dump collection.
      * @param failingUnit The identifier of the failing unit.
+     * @param collection State of the running collection.
+     * @param limit Time the chip-op is abandoned at, none to wait for it.
+     * @return The outcome of the chip-op.
      */
-    void collectDumpFromSBE(struct pdbg_target* chip,
-                            const std::filesystem::path& path, uint32_t id,
-                            uint8_t type, uint8_t clockState,
-                            uint64_t failingUnit);
+    ChipOpStatus collectDumpFromSBE(
+        const Chip& chip, const std::filesystem::path& path, uint32_t id,
+        uint8_t type, uint8_t clockState, uint64_t failingUnit,
+        CollectionState& collection, const ChipOpLimit& limit);
+
+    /** @brief Progress of the dump collection from a proc and its OCMBs */
+    struct ProcPipeline;
 
     /**
-     * @brief Initializes the PDBG library.
+     * @brief Returns the number of workers used when none is set.
+     */
+    static size_t defaultWorkerCount();
+
+    /**
+     * @brief Collects the dumps of a proc, starting from a clock state.
+     *
+     * Each proc runs its own pipeline: the proc dump in the first clock
+     * state, the dumps of its OCMBs, then the proc dump in the remaining
+     * clock states. A proc moves to the next clock state as soon as its own
+     * previous steps are done, without waiting for the other procs. When
+     * the OCMBs are reached their tasks are queued on the pool, and the
+     * last OCMB task resumes the pipeline.
      *
-     * Prepares the PDBG library for interacting with processor targets. This
-     * must be called before any PDBG-related operations are performed.
+     * @param pool The pool running the collection tasks.
+     * @param pipeline The proc and its OCMBs.
+     * @param state Index of the clock state to start from.
      */
-    void initializePdbg();
+    void runProcPipeline(WorkerPool& pool,
+                         const std::shared_ptr<ProcPipeline>& pipeline,
+                         size_t state);
 
     /**
-     * @brief Launches asynchronous dump collection tasks for a set of targets.
+     * @brief Queues the OCMB dumps of a proc allowed to start.
      *
-     * This method initiates the dump collection process asynchronously for each
-     * target provided in the `targets` vector. It launches a separate
-     * asynchronous task for each target, where each task calls
-     * `collectDumpFromSBE` with the specified parameters, including the clock
-     * state.
+     * Keeps at most maxOcmbsPerProc chip-ops in flight on the proc and
+     * maxOcmbsPerLink chip-ops in flight on each FSI link.
      *
-     * @param type The type of the dump to collect. This could be a hardware
-     * dump, software dump, etc., as defined by the SBE dump type enumeration.
-     * @param id A unique identifier for the dump collection operation. This ID
-     * is used to tag the collected dump for identification.
-     * @param path The filesystem path where the collected dumps should be
-     * stored. Each dump file will be stored under this directory.
-     * @param failingUnit The identifier of the unit or component that is
-     * failing or suspected to be the cause of the issue prompting the dump
-     * collection. This is used for diagnostic purposes.
-     * @param cstate The clock state during the dump collection. This parameter
-     *               dictates whether the dump should be collected with the
-     * clocks running (SBE_CLOCK_ON) or with the clocks stopped (SBE_CLOCK_OFF).
-     * @param targetMap A map of `pdbg_target*` representing the targets from
-     * which dumps should be collected. The key is the proc target with the
-     * list of ocmb targets associated with the proc.
+     * @param pool The pool running the collection tasks.
+     * @param pipeline The proc and its OCMBs.
+     */
+    void dispatchOcmbDumps(WorkerPool& pool,
+                           const std::shared_ptr<ProcPipeline>& pipeline);
+
+    /**
+     * @brief Collects the dump of an OCMB, then queues the next OCMB or
+     * resumes the proc pipeline after the last one.
      *
-     * @return A vector of `std::future<void>` objects. Each future represents
-     * the completion state of an asynchronous dump collection task. The caller
-     *         can wait on these futures to determine when all dump collection
-     * tasks have completed. Exceptions thrown by the asynchronous tasks are
-     * captured by the futures and can be rethrown when the futures are
-     * accessed.
+     * @param pool The pool running the collection tasks.
+     * @param pipeline The proc and its OCMBs.
+     * @param index Index of the OCMB in the pipeline.
      */
-    std::vector<std::future<void>> spawnDumpCollectionProcesses(
-        uint8_t type, uint32_t id, const std::filesystem::path& path,
-        uint64_t failingUnit, uint8_t cstate, const TargetMap& targetMap);
+    void collectOcmbDump(WorkerPool& pool,
+                         const std::shared_ptr<ProcPipeline>& pipeline,
+                         size_t index);
 
     /** @brief This function creates the new dump file in dump file name
-     * format and then writes the contents into it.
+     * format, the contents are written into it as they are received.
      *  @param path - Path to dump file
      *  @param id - A unique id assigned to dump to be collected
      *  @param clockState - Clock state, ON or Off
      *  @param nodeNum - Node containing the chip
      *  @param chipName - Name of the chip
      *  @param chipPos - Chip position of the failing unit
-     *  @param dataPtr - Content to write to file
+     *  @return The dump file, nullptr if the file cannot be created
+     */
+    std::unique_ptr<DumpFile> createDumpFile(
+        const std::filesystem::path& path, const uint32_t id,
+        const uint8_t clockState, const uint8_t nodeNum,
+        const std::string& chipName, const uint8_t chipPos);
+
+    /** @brief Appends dump data to the dump file, the file is dropped if
+     * the data cannot be written.
+     *  @param dumpFile - The dump file, nullptr if it is already dropped
+     *  @param data - Content to write to file
      *  @param len - Length of the content
      */
-    void writeDumpFile(const std::filesystem::path& path, const uint32_t id,
-                       const uint8_t clockState, const uint8_t nodeNum,
-                       const std::string& chipName, const uint8_t chipPos,
-                       util::DumpDataPtr& dataPtr, const uint32_t len);
+    void writeDumpData(std::unique_ptr<DumpFile>& dumpFile,
+                       const uint8_t* data, size_t len);
+
+    /** @brief Moves a completely written dump file to its final name.
+     *  @param dumpFile - The dump file, nullptr if it is already dropped
+     */
+    void commitDumpFile(std::unique_ptr<DumpFile>& dumpFile);
+
+    /** @brief Logs and reports a failure to write a dump file.
+     *  @param dumpFile - The dump file
+     *  @param e - The write failure
+     */
+    void reportDumpWriteFailure(const DumpFile& dumpFile,
+                                const std::system_error& e);
+
+    /** @brief Writes the trace of a collection in its dump, if traced.
+     *  @param trace - The trace, nullptr if the collection is not traced
+     *  @param path - Path of the dump
+     */
+    void writeTrace(const TraceRecorder* trace,
+                    const std::filesystem::path& path);
+
+    /** @brief Writes the outcome of the chip-ops of a collection in the
+     * manifest.json of its dump.
+     *  @param collection - State of the collection
+     *  @param path - Path of the dump
+     */
+    void writeManifest(CollectionState& collection,
+                       const std::filesystem::path& path);
 
     /**
      * @brief Determines if fastarray collection is needed based on dump type
@@ -196,6 +405,35 @@ class SbeDumpCollector
                    : 0;
     }
 
+    /**
+     * @brief Logs the SBE dumps requested during the collection, after
+     * waiting for them if a wait is set.
+     *
+     * The wait ends at the deadline of the collection, if any.
+     *
+     * @param collection State of the running collection.
+     */
+    void reportNestedDumps(CollectionState& collection);
+
+    /**
+     * Reports an SBE chip-op failure through the error reporter of the
+     * collection. The exception object keeps the FFDC files open until the
+     * report is done, so it is handed to the reporter rather than copied.
+     *
+     * @param error - The caught openpower::phal::sbeError_t.
+     * @param chipPos - The position of the chip where the error occurred.
+     * @param sbeType - The type of SBE, used to determine the event log
+     * message.
+     * @param cmdClass - The command class associated with the SBE operation.
+     * @param cmdType - The specific type of command within the command class.
+     * @param path - Dump collection path.
+     * @param collection - State of the running collection.
+     */
+    void reportError(std::exception_ptr error, uint64_t chipPos,
+                     SBETypes sbeType, uint32_t cmdClass, uint32_t cmdType,
+                     const std::filesystem::path& path,
+                     CollectionState& collection);
+
     /**
      * Logs an error and creates a PEL for SBE chip-op failures.
      *
@@ -207,27 +445,17 @@ class SbeDumpCollector
      * @param cmdClass - The command class associated with the SBE operation.
      * @param cmdType - The specific type of command within the command class.
      * @param path - Dump collection path.
+     * @param batch - Batch creating the PELs of the FFDC packets, the
+     * caller adds them to the dump with addBatchLogsToDump.
+     * @param nestedDumps - Receives the entry of the SBE dump requested.
      *
      */
-    bool logErrorAndCreatePEL(const openpower::phal::sbeError_t& sbeError,
+    void logErrorAndCreatePEL(const openpower::phal::sbeError_t& sbeError,
                               uint64_t chipPos, SBETypes sbeType,
                               uint32_t cmdClass, uint32_t cmdType,
-                              const std::filesystem::path& path);
-
-    /**
-     * Determines the type of SBE for a given chip target.
-     *
-     * @param chip - A pointer to a pdbg_target structure representing the chip.
-     * @return The SBE type for the given chip target.
-     */
-    inline SBETypes getSBEType([[maybe_unused]] struct pdbg_target* chip)
-    {
-        if (is_ody_ocmb_chip(chip))
-        {
-            return SBETypes::OCMB;
-        }
-        return SBETypes::PROC;
-    }
+                              const std::filesystem::path& path,
+                              openpower::dump::pel::PELBatch& batch,
+                              std::vector<std::string>& nestedDumps);
 
     /**
      * @brief Executes thread stop on a processor target
@@ -239,17 +467,33 @@ class SbeDumpCollector
      * In case of SBE command failure or non-critical errors, it continues with
      * the dump collection process.
      *
-     * @param target Pointer to the pdbg target structure representing the
-     *               processor to perform the thread stop on.
+     * @param target The processor to perform the thread stop on.
      * @param path Dump collection path
+     * @param collection State of the running collection.
+     * @param limit Time the thread stop is abandoned at, none to wait for it.
      * @return true If the thread stop was successful or in case of non-critical
      *              errors where dump collection can proceed.
      * @return false If the SBE is not ready for chip-ops or in case of critical
      *               errors like timeouts, indicating the processor should be
-     *               excluded from the dump collection.
+     *               excluded from the dump collection. An abandoned thread
+     *               stop excludes the processor as well.
+     */
+    bool executeThreadStop(const Chip& target,
+                           const std::filesystem::path& path,
+                           CollectionState& collection,
+                           const ChipOpLimit& limit);
+
+    /**
+     * @brief Waits for the PELs of a batch and adds their information to
+     * the dump
+     * @param batch - Batch creating the PELs
+     * @param chipName - Resource Name
+     * @param chipPos - Resource number
+     * @param path - Dump collection path
      */
-    bool executeThreadStop(struct pdbg_target* target,
-                           const std::filesystem::path& path);
+    void addBatchLogsToDump(openpower::dump::pel::PELBatch& batch,
+                            const std::string& chipName, uint64_t chipPos,
+                            const std::filesystem::path& path);
 
     /**
      * @brief Add Failure log information to info.yaml file
@@ -0,0 +1,98 @@
+#include "service_cache.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <exception>
+
+namespace openpower::dump::util
+{
+
+ServiceCache& ServiceCache::instance()
+{
+    static ServiceCache cache;
+    return cache;
+}
+
+ServiceCache::ServiceCache()
+{
+    try
+    {
+        bus = std::make_unique<sdbusplus::bus_t>(sdbusplus::bus::new_system());
+        match = std::make_unique<sdbusplus::match_t>(
+            *bus, sdbusplus::bus::match::rules::nameOwnerChanged(),
+            [this](sdbusplus::message_t& msg) { ownerChanged(msg); });
+    }
+    catch (const std::exception& e)
+    {
+        // Without the signals a cached entry could go stale, look every
+        // service up instead
+        lg2::error("Service cache disabled, {ERROR}", "ERROR", e);
+        match.reset();
+        bus.reset();
+    }
+}
+
+std::string ServiceCache::get(const std::string& intf, const std::string& path,
+                              const Lookup& lookup)
+{
+    auto key = std::make_pair(intf, path);
+    {
+        std::lock_guard lock(mutex);
+        if (bus)
+        {
+            processSignals();
+            auto it = services.find(key);
+            if (it != services.end())
+            {
+                hitCount++;
+                return it->second;
+            }
+        }
+    }
+
+    missCount++;
+    auto service = lookup();
+    lg2::debug("Service {SERVICE} for {INTERFACE} {PATH}, hits {HITS} "
+               "misses {MISSES}",
+               "SERVICE", service, "INTERFACE", intf, "PATH", path, "HITS",
+               hitCount.load(), "MISSES", missCount.load());
+
+    std::lock_guard lock(mutex);
+    if (bus)
+    {
+        // An owner change seen meanwhile may concern this service
+        processSignals();
+        services[key] = service;
+    }
+    return service;
+}
+
+void ServiceCache::ownerChanged(sdbusplus::message_t& msg)
+{
+    std::string name;
+    std::string oldOwner;
+    std::string newOwner;
+    msg.read(name, oldOwner, newOwner);
+
+    std::erase_if(services,
+                  [&name](const auto& entry) { return entry.second == name; });
+}
+
+void ServiceCache::processSignals()
+{
+    try
+    {
+        while (bus->process_discard())
+        {}
+    }
+    catch (const std::exception& e)
+    {
+        // The owner changes can no longer be seen, stop caching
+        lg2::error("Service cache disabled, {ERROR}", "ERROR", e);
+        services.clear();
+        match.reset();
+        bus.reset();
+    }
+}
+
+} // namespace openpower::dump::util
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace openpower::dump::util
+{
+
+/**
+ * @class ServiceCache
+ * @brief Process wide cache of the services found through the mapper,
+ * keyed by interface and object path.
+ *
+ * The cache watches NameOwnerChanged on a connection of its own and drops
+ * the entries of a service whose owner changes, so a restarted service is
+ * looked up again. The pending signals are processed before every lookup,
+ * no thread is needed.
+ */
+class ServiceCache
+{
+  public:
+    using Lookup = std::function<std::string()>;
+
+    ServiceCache(const ServiceCache&) = delete;
+    ServiceCache& operator=(const ServiceCache&) = delete;
+    ServiceCache(ServiceCache&&) = delete;
+    ServiceCache& operator=(ServiceCache&&) = delete;
+    ~ServiceCache() = default;
+
+    /**
+     * @brief Returns the cache of the process.
+     */
+    static ServiceCache& instance();
+
+    /**
+     * @brief Returns the service implementing an interface on a path.
+     *
+     * @param[in] intf - D-Bus interface
+     * @param[in] path - D-Bus object path
+     * @param[in] lookup - Finds the service on a miss, the result is cached
+     *
+     * @return The service name
+     *
+     * Exceptions: whatever lookup raises, nothing is cached then
+     */
+    std::string get(const std::string& intf, const std::string& path,
+                    const Lookup& lookup);
+
+    /** @brief Number of lookups answered from the cache */
+    uint64_t hits() const
+    {
+        return hitCount;
+    }
+
+    /** @brief Number of lookups that needed the mapper */
+    uint64_t misses() const
+    {
+        return missCount;
+    }
+
+  private:
+    ServiceCache();
+
+    /** @brief Protects the members below */
+    std::mutex mutex;
+
+    /** @brief Connection receiving NameOwnerChanged, null if unavailable */
+    std::unique_ptr<sdbusplus::bus_t> bus;
+
+    /** @brief NameOwnerChanged match */
+    std::unique_ptr<sdbusplus::match_t> match;
+
+    /** @brief Service names keyed by interface and path */
+    std::map<std::pair<std::string, std::string>, std::string> services;
+
+    /** @brief Lookups answered from the cache */
+    std::atomic<uint64_t> hitCount = 0;
+
+    /** @brief Lookups that needed the mapper */
+    std::atomic<uint64_t> missCount = 0;
+
+    /**
+     * @brief Drops the entries of a service whose owner changed.
+     */
+    void ownerChanged(sdbusplus::message_t& msg);
+
+    /**
+     * @brief Processes the pending signals, called with the mutex held.
+     */
+    void processSignals();
+};
+
+} // namespace openpower::dump::util
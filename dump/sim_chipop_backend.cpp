@@ -0,0 +1,172 @@
+#include "sim_chipop_backend.hpp"
+
+#include "sbe_consts.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace openpower::dump::sbe_chipop
+{
+
+using namespace openpower::phal;
+
+const SimChipConfig& SimChipOpBackend::getConfig(const Chip& chip) const
+{
+    auto it = topology.chips.find({chip.sbeType, chip.position});
+    if (it != topology.chips.end())
+    {
+        return it->second;
+    }
+    return chip.sbeType == SBETypes::OCMB ? topology.ocmb : topology.proc;
+}
+
+std::vector<Chip> SimChipOpBackend::getFunctionalProcs()
+{
+    std::vector<Chip> procs;
+    for (size_t i = 0; i < topology.procs; i++)
+    {
+        procs.push_back({SBETypes::PROC, static_cast<uint32_t>(i), nullptr});
+    }
+    return procs;
+}
+
+std::vector<Chip> SimChipOpBackend::getFunctionalOcmbs(const Chip& proc)
+{
+    std::vector<Chip> ocmbs;
+    for (size_t i = 0; i < topology.ocmbsPerProc; i++)
+    {
+        ocmbs.push_back(
+            {SBETypes::OCMB,
+             static_cast<uint32_t>(proc.position * topology.ocmbsPerProc + i),
+             nullptr, static_cast<uint32_t>(i / topology.ocmbsPerLink)});
+    }
+    return ocmbs;
+}
+
+void SimChipOpBackend::threadStop(const Chip& proc)
+{
+    const auto& config = getConfig(proc);
+    std::this_thread::sleep_for(config.latency);
+    if (config.threadStopError)
+    {
+        throw sbeError_t(*config.threadStopError);
+    }
+}
+
+void SimChipOpBackend::getDump(const Chip& chip, uint8_t /*type*/,
+                               uint8_t /*clockState*/,
+                               uint8_t collectFastArray,
+                               const DumpChunkHandler& handler)
+{
+    const auto& config = getConfig(chip);
+    std::this_thread::sleep_for(config.latency);
+    if (config.dumpError &&
+        *config.dumpError != exception::SBE_INTERNAL_FFDC_DATA)
+    {
+        throw sbeError_t(*config.dumpError);
+    }
+
+    size_t len =
+        config.dumpSize + (collectFastArray ? config.fastArraySize : 0);
+    std::vector<uint8_t> chunk(std::min(len, dumpChunkSize),
+                               static_cast<uint8_t>(chip.position));
+    for (size_t offset = 0; offset < len; offset += chunk.size())
+    {
+        handler(chunk.data(), std::min(chunk.size(), len - offset));
+    }
+
+    // The chip-op completed but the SBE reported unrelated FFDC
+    if (config.dumpError)
+    {
+        throw sbeError_t(*config.dumpError);
+    }
+}
+
+SbeDumpTarget SimChipOpBackend::prepareSbeDump(uint32_t failingUnit,
+                                               int sbeTypeId)
+{
+    SbeDumpTarget sbeTarget;
+    sbeTarget.chip.position = failingUnit;
+    sbeTarget.chip.sbeType = (sbeTypeId == SBE::SBE_DUMP_TYPE_MSBE)
+                                 ? SBETypes::OCMB
+                                 : SBETypes::PROC;
+    return sbeTarget;
+}
+
+void SimChipOpBackend::checkSbeState(const SbeDumpTarget& target,
+                                     int /*sbeTypeId*/)
+{
+    const auto& config = getConfig(target.chip);
+    if (config.dumpError == exception::SBE_CHIPOP_NOT_ALLOWED)
+    {
+        throw sbeError_t(*config.dumpError);
+    }
+}
+
+void SimChipOpBackend::executeSbeExtractRc(
+    const SbeDumpTarget& target, const std::filesystem::path& /*dumpPath*/,
+    int /*sbeTypeId*/)
+{
+    std::this_thread::sleep_for(getConfig(target.chip).latency);
+}
+
+void SimChipOpBackend::writeSbeDumpFile(
+    const SbeDumpTarget& target, const std::filesystem::path& file) const
+{
+    const auto& config = getConfig(target.chip);
+    std::this_thread::sleep_for(config.latency);
+    if (config.dumpError &&
+        *config.dumpError != exception::SBE_CHIPOP_NOT_ALLOWED)
+    {
+        throw sbeError_t(*config.dumpError);
+    }
+
+    std::ofstream outfile(file, std::ios::out | std::ios::binary);
+    std::vector<char> buffer(config.dumpSize,
+                             static_cast<char>(target.chip.position));
+    outfile.write(buffer.data(), buffer.size());
+}
+
+void SimChipOpBackend::collectLocalRegDump(
+    const SbeDumpTarget& target, const std::filesystem::path& dumpPath,
+    const std::string& baseFilename, int /*sbeTypeId*/)
+{
+    writeSbeDumpFile(target, dumpPath / (baseFilename + "localreg"));
+}
+
+void SimChipOpBackend::collectPIBMSRegDump(
+    const SbeDumpTarget& target, const std::filesystem::path& dumpPath,
+    const std::string& baseFilename, int /*sbeTypeId*/)
+{
+    writeSbeDumpFile(target, dumpPath / (baseFilename + "pibms_reg_dump"));
+}
+
+void SimChipOpBackend::collectPIBMEMDump(
+    const SbeDumpTarget& target, const std::filesystem::path& dumpPath,
+    const std::string& baseFilename, int /*sbeTypeId*/)
+{
+    writeSbeDumpFile(target, dumpPath / (baseFilename + "pibmem_dump"));
+}
+
+void SimChipOpBackend::collectPPEState(const SbeDumpTarget& target,
+                                       const std::filesystem::path& dumpPath,
+                                       const std::string& baseFilename,
+                                       int /*sbeTypeId*/)
+{
+    writeSbeDumpFile(target, dumpPath / (baseFilename + "ppe_state"));
+}
+
+void SimChipOpBackend::finalizeSbeDump(
+    const SbeDumpTarget& target, const std::filesystem::path& /*dumpPath*/,
+    bool success, int /*sbeTypeId*/)
+{
+    lg2::info("Simulated SBE dump finalized: position({POSITION}) "
+              "success({SUCCESS})",
+              "POSITION", target.chip.position, "SUCCESS", success);
+}
+
+} // namespace openpower::dump::sbe_chipop
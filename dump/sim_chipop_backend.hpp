@@ -0,0 +1,146 @@
+#pragma once
+
+#include "chipop_backend.hpp"
+
+#include <phal_exception.H>
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <utility>
+
+namespace openpower::dump::sbe_chipop
+{
+
+/**
+ * @struct SimChipConfig
+ * @brief Behaviour of a simulated chip.
+ */
+struct SimChipConfig
+{
+    /** @brief Size of the dump data returned by get dump */
+    uint32_t dumpSize = 1024 * 1024;
+
+    /** @brief Additional dump data returned when fastarray is requested */
+    uint32_t fastArraySize = 0;
+
+    /** @brief Time taken by each chip-op on the chip */
+    std::chrono::microseconds latency{100000};
+
+    /** @brief Error raised by the get dump chip-op, if any */
+    std::optional<openpower::phal::exception::ERR_TYPE> dumpError;
+
+    /** @brief Error raised by the thread stop chip-op, if any */
+    std::optional<openpower::phal::exception::ERR_TYPE> threadStopError;
+};
+
+/**
+ * @struct SimTopology
+ * @brief Topology and chip behaviour of a simulated system.
+ */
+struct SimTopology
+{
+    /** @brief Number of functional procs */
+    size_t procs = 1;
+
+    /** @brief Number of functional Odyssey OCMBs attached to each proc */
+    size_t ocmbsPerProc = 0;
+
+    /** @brief Number of OCMBs sharing each FSI link of a proc */
+    size_t ocmbsPerLink = 1;
+
+    /** @brief Behaviour of the procs without an override */
+    SimChipConfig proc;
+
+    /** @brief Behaviour of the OCMBs without an override */
+    SimChipConfig ocmb{256 * 1024, 0, std::chrono::microseconds{50000}, {}, {}};
+
+    /** @brief Per chip overrides keyed by SBE type and position */
+    std::map<std::pair<SBETypes, uint32_t>, SimChipConfig> chips;
+};
+
+/**
+ * @class SimChipOpBackend
+ * @brief Chip-op backend simulating the SBEs of a system.
+ *
+ * Chip-ops sleep for the configured latency and return generated dump data
+ * of the configured size, or raise the configured SBE error. Used to measure
+ * the collection pipeline without hardware.
+ */
+class SimChipOpBackend : public ChipOpBackend
+{
+  public:
+    /**
+     * @brief Constructs a simulated backend.
+     *
+     * @param[in] topology - The simulated system
+     */
+    explicit SimChipOpBackend(const SimTopology& topology) : topology(topology)
+    {}
+
+    ~SimChipOpBackend() override = default;
+
+    void initialize() override {}
+
+    void initializeHwps() override {}
+
+    std::vector<Chip> getFunctionalProcs() override;
+
+    std::vector<Chip> getFunctionalOcmbs(const Chip& proc) override;
+
+    void threadStop(const Chip& proc) override;
+
+    void getDump(const Chip& chip, uint8_t type, uint8_t clockState,
+                 uint8_t collectFastArray,
+                 const DumpChunkHandler& handler) override;
+
+    SbeDumpTarget prepareSbeDump(uint32_t failingUnit, int sbeTypeId) override;
+
+    void checkSbeState(const SbeDumpTarget& target, int sbeTypeId) override;
+
+    void executeSbeExtractRc(const SbeDumpTarget& target,
+                             const std::filesystem::path& dumpPath,
+                             int sbeTypeId) override;
+
+    void collectLocalRegDump(const SbeDumpTarget& target,
+                             const std::filesystem::path& dumpPath,
+                             const std::string& baseFilename,
+                             int sbeTypeId) override;
+
+    void collectPIBMSRegDump(const SbeDumpTarget& target,
+                             const std::filesystem::path& dumpPath,
+                             const std::string& baseFilename,
+                             int sbeTypeId) override;
+
+    void collectPIBMEMDump(const SbeDumpTarget& target,
+                           const std::filesystem::path& dumpPath,
+                           const std::string& baseFilename,
+                           int sbeTypeId) override;
+
+    void collectPPEState(const SbeDumpTarget& target,
+                         const std::filesystem::path& dumpPath,
+                         const std::string& baseFilename,
+                         int sbeTypeId) override;
+
+    void finalizeSbeDump(const SbeDumpTarget& target,
+                         const std::filesystem::path& dumpPath, bool success,
+                         int sbeTypeId) override;
+
+  private:
+    /** @brief The simulated system */
+    SimTopology topology;
+
+    /**
+     * @brief Returns the behaviour of a chip.
+     */
+    const SimChipConfig& getConfig(const Chip& chip) const;
+
+    /**
+     * @brief Simulates an SBE dump HWP writing a file of the dump size.
+     */
+    void writeSbeDumpFile(const SbeDumpTarget& target,
+                          const std::filesystem::path& file) const;
+};
+
+} // namespace openpower::dump::sbe_chipop
@@ -0,0 +1,192 @@
+#include "topology_snapshot.hpp"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace openpower::dump::sbe_chipop
+{
+
+namespace
+{
+
+constexpr auto bootIdPath = "/proc/sys/kernel/random/boot_id";
+
+/** @brief "ODCT" read as a native integer */
+constexpr uint32_t snapshotMagic = 0x5443444F;
+constexpr uint32_t snapshotVersion = 1;
+
+/** @brief Bound on the entries of a snapshot, guards against corruption */
+constexpr uint32_t maxEntries = 4096;
+
+/** @brief Appends the native representation of a value */
+template <typename T>
+void put(std::string& buffer, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/** @brief Reads values from a snapshot, failing on a short read */
+class Reader
+{
+  public:
+    explicit Reader(std::string_view data) : data(data) {}
+
+    template <typename T>
+    bool get(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (data.size() < sizeof(value))
+        {
+            return false;
+        }
+        std::memcpy(&value, data.data(), sizeof(value));
+        data.remove_prefix(sizeof(value));
+        return true;
+    }
+
+    bool get(std::string& value, size_t len)
+    {
+        if (data.size() < len)
+        {
+            return false;
+        }
+        value.assign(data.substr(0, len));
+        data.remove_prefix(len);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return data.empty();
+    }
+
+  private:
+    std::string_view data;
+};
+
+} // namespace
+
+std::optional<TopologyKey> TopologyKey::current(
+    const std::filesystem::path& dtb)
+{
+    TopologyKey key;
+
+    std::ifstream bootId(bootIdPath);
+    if (!bootId.read(key.bootId.data(), key.bootId.size()))
+    {
+        return std::nullopt;
+    }
+
+    struct stat st{};
+    if (stat(dtb.c_str(), &st) != 0)
+    {
+        return std::nullopt;
+    }
+    key.dtbDevice = st.st_dev;
+    key.dtbInode = st.st_ino;
+    key.dtbSize = st.st_size;
+    key.dtbMtime = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    return key;
+}
+
+std::optional<TopologySnapshot> TopologySnapshot::load(
+    const std::filesystem::path& path, const TopologyKey& key)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return std::nullopt;
+    }
+    std::string data{std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>()};
+
+    Reader reader(data);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    TopologySnapshot snapshot;
+    if (!reader.get(magic) || magic != snapshotMagic ||
+        !reader.get(version) || version != snapshotVersion ||
+        !reader.get(snapshot.key) || snapshot.key != key)
+    {
+        return std::nullopt;
+    }
+
+    uint32_t count = 0;
+    if (!reader.get(count) || count > maxEntries)
+    {
+        return std::nullopt;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        TopologyEntry entry;
+        uint8_t sbeType = 0;
+        uint8_t functional = 0;
+        uint16_t locationCodeLen = 0;
+        if (!reader.get(sbeType) || !reader.get(functional) ||
+            !reader.get(entry.position) || !reader.get(entry.parent) ||
+            !reader.get(entry.link) || !reader.get(locationCodeLen) ||
+            !reader.get(entry.locationCode, locationCodeLen))
+        {
+            return std::nullopt;
+        }
+        entry.sbeType = static_cast<SBETypes>(sbeType);
+        entry.functional = (functional != 0);
+        snapshot.entries.push_back(std::move(entry));
+    }
+    if (!reader.empty())
+    {
+        return std::nullopt;
+    }
+    return snapshot;
+}
+
+void TopologySnapshot::save(const std::filesystem::path& path) const
+{
+    std::string buffer;
+    put(buffer, snapshotMagic);
+    put(buffer, snapshotVersion);
+    put(buffer, key);
+    put(buffer, static_cast<uint32_t>(entries.size()));
+    for (const auto& entry : entries)
+    {
+        auto locationCodeLen = static_cast<uint16_t>(
+            std::min<size_t>(entry.locationCode.size(), UINT16_MAX));
+        put(buffer, static_cast<uint8_t>(entry.sbeType));
+        put(buffer, static_cast<uint8_t>(entry.functional));
+        put(buffer, entry.position);
+        put(buffer, entry.parent);
+        put(buffer, entry.link);
+        put(buffer, locationCodeLen);
+        buffer.append(entry.locationCode, 0, locationCodeLen);
+    }
+
+    std::filesystem::create_directories(path.parent_path());
+
+    // Readers only ever see a complete snapshot
+    auto tmpPath = path;
+    tmpPath += "." + std::to_string(getpid());
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.write(buffer.data(), buffer.size()) || !file.flush())
+        {
+            auto err = errno;
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            throw std::system_error(err, std::generic_category(),
+                                    "Failed to write " + tmpPath.string());
+        }
+    }
+    std::filesystem::rename(tmpPath, path);
+}
+
+} // namespace openpower::dump::sbe_chipop
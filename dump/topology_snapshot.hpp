@@ -0,0 +1,114 @@
+#pragma once
+
+#include "sbe_type.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace openpower::dump::sbe_chipop
+{
+
+/** @brief Default location of the topology snapshot */
+constexpr auto topologySnapshotPath =
+    "/run/openpower-debug-collector/topology.bin";
+
+/**
+ * @struct TopologyKey
+ * @brief Identifies the topology a snapshot was taken from.
+ *
+ * The BMC boot id changes on every BMC boot, the identity of the device
+ * tree file changes whenever the host boot rewrites the functional state
+ * of the targets. Both are read without touching the hardware.
+ */
+struct TopologyKey
+{
+    /** @brief Kernel boot id of the BMC */
+    std::array<char, 36> bootId{};
+
+    /** @brief Device, inode, size and mtime(ns) of the device tree file */
+    uint64_t dtbDevice = 0;
+    uint64_t dtbInode = 0;
+    uint64_t dtbSize = 0;
+    int64_t dtbMtime = 0;
+
+    bool operator==(const TopologyKey&) const = default;
+
+    /**
+     * @brief Reads the key of the current topology.
+     *
+     * @param[in] dtb - Device tree file in use
+     *
+     * @return The key, std::nullopt if the boot id or the device tree file
+     *         cannot be read
+     */
+    static std::optional<TopologyKey> current(const std::filesystem::path& dtb);
+};
+
+/**
+ * @struct TopologyEntry
+ * @brief A proc or OCMB chip of the topology.
+ */
+struct TopologyEntry
+{
+    /** @brief SBE type of the chip */
+    SBETypes sbeType = SBETypes::PROC;
+
+    /** @brief Position of the chip, the pdbg target index */
+    uint32_t position = 0;
+
+    /** @brief Position of the proc an OCMB is attached to */
+    uint32_t parent = 0;
+
+    /** @brief FSI link used to reach an OCMB */
+    uint32_t link = 0;
+
+    /** @brief Whether the chip was functional when the snapshot was taken */
+    bool functional = false;
+
+    /** @brief Location code of the chip, empty if unknown */
+    std::string locationCode;
+};
+
+/**
+ * @struct TopologySnapshot
+ * @brief The procs and Odyssey OCMBs of the system with their functional
+ * state, saved once per host boot so later collections skip the probing.
+ *
+ * The snapshot is a small binary file written atomically, it is only used
+ * while its key matches the current topology.
+ */
+struct TopologySnapshot
+{
+    /** @brief Topology the snapshot was taken from */
+    TopologyKey key;
+
+    /** @brief Procs followed by the OCMBs of the functional procs */
+    std::vector<TopologyEntry> entries;
+
+    /**
+     * @brief Loads a snapshot.
+     *
+     * @param[in] path - Snapshot file
+     * @param[in] key - Key of the current topology
+     *
+     * @return The snapshot, std::nullopt if it is missing, corrupted or
+     *         taken from another topology
+     */
+    static std::optional<TopologySnapshot> load(
+        const std::filesystem::path& path, const TopologyKey& key);
+
+    /**
+     * @brief Saves the snapshot, replacing the file atomically.
+     *
+     * @param[in] path - Snapshot file, its directory is created if needed
+     *
+     * Exceptions: std::system_error on failure
+     */
+    void save(const std::filesystem::path& path) const;
+};
+
+} // namespace openpower::dump::sbe_chipop
@@ -0,0 +1,76 @@
+#include "trace_recorder.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace openpower::dump
+{
+
+namespace
+{
+
+uint64_t toUs(TraceRecorder::Clock::duration elapsed)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+    return static_cast<uint64_t>(std::max<int64_t>(us.count(), 0));
+}
+
+} // namespace
+
+void TraceRecorder::record(const char* category, std::string name,
+                           Clock::time_point begin, Clock::time_point end,
+                           nlohmann::json args)
+{
+    threads.local().push_back({category, std::move(name), toUs(begin - start),
+                               toUs(end - begin), std::move(args)});
+}
+
+void TraceRecorder::write(const std::filesystem::path& file) const
+{
+    auto pid = getpid();
+    auto events = nlohmann::json::array();
+    events.push_back({{"ph", "M"},
+                      {"name", "process_name"},
+                      {"pid", pid},
+                      {"args", {{"name", "dump-collect"}}}});
+
+    // The threads are numbered in the order they first recorded a step
+    threads.forEach([&events, pid](size_t tid,
+                                   const std::vector<Event>& thread) {
+        events.push_back({{"ph", "M"},
+                          {"name", "thread_name"},
+                          {"pid", pid},
+                          {"tid", tid},
+                          {"args", {{"name", std::format("thread {}", tid)}}}});
+        for (const auto& event : thread)
+        {
+            nlohmann::json json = {{"ph", "X"},
+                                   {"cat", event.category},
+                                   {"name", event.name},
+                                   {"pid", pid},
+                                   {"tid", tid},
+                                   {"ts", event.beginUs},
+                                   {"dur", event.durationUs}};
+            if (!event.args.is_null())
+            {
+                json["args"] = event.args;
+            }
+            events.push_back(std::move(json));
+        }
+    });
+
+    std::ofstream out{file};
+    out << nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+    out.close();
+    if (!out)
+    {
+        throw std::runtime_error(
+            std::format("Failed to write the trace {}", file.string()));
+    }
+}
+
+} // namespace openpower::dump
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "per_thread.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace openpower::dump
+{
+
+/**
+ * @class TraceRecorder
+ * @brief Records the steps of a dump collection as Chrome trace events.
+ *
+ * Each step is a complete ("X") event on the track of the thread which ran
+ * it, so the file written by write() shows what every worker did over time
+ * when loaded in chrome://tracing or Perfetto. Recording takes no lock after
+ * the first event of a thread. write() must only be called once the
+ * recording threads are done.
+ */
+class TraceRecorder
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    TraceRecorder() = default;
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+    TraceRecorder(TraceRecorder&&) = delete;
+    TraceRecorder& operator=(TraceRecorder&&) = delete;
+    ~TraceRecorder() = default;
+
+    /**
+     * @brief Records a step run by the calling thread.
+     *
+     * @param[in] category - Category of the step, e.g. "chipop"
+     * @param[in] name - Name shown on the step
+     * @param[in] begin - Start of the step
+     * @param[in] end - End of the step
+     * @param[in] args - Details shown when the step is selected
+     */
+    void record(const char* category, std::string name, Clock::time_point begin,
+                Clock::time_point end, nlohmann::json args);
+
+    /**
+     * @brief Writes the trace events in the Chrome JSON object format.
+     *
+     * @param[in] file - Path of the trace file
+     *
+     * Throws std::runtime_error if the file cannot be written.
+     */
+    void write(const std::filesystem::path& file) const;
+
+  private:
+    /** @brief A recorded step */
+    struct Event
+    {
+        const char* category;
+        std::string name;
+        uint64_t beginUs;
+        uint64_t durationUs;
+        nlohmann::json args;
+    };
+
+    /** @brief Start of the trace, timestamps are relative to it */
+    const Clock::time_point start = Clock::now();
+
+    /** @brief Steps of each thread */
+    PerThread<std::vector<Event>> threads;
+};
+
+/**
+ * @class TraceSpan
+ * @brief Records the time spent in a scope as a trace event.
+ *
+ * Does nothing when there is no recorder, so the steps of a collection are
+ * traced unconditionally and only cost a null check when tracing is off.
+ */
+class TraceSpan
+{
+  public:
+    TraceSpan(TraceRecorder* recorder, const char* category, std::string name,
+              nlohmann::json args = nullptr) :
+        recorder(recorder), category(category), name(std::move(name)),
+        args(std::move(args))
+    {
+        if (recorder != nullptr)
+        {
+            begin = TraceRecorder::Clock::now();
+        }
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    TraceSpan(TraceSpan&&) = delete;
+    TraceSpan& operator=(TraceSpan&&) = delete;
+
+    ~TraceSpan()
+    {
+        if (recorder != nullptr)
+        {
+            recorder->record(category, std::move(name), begin,
+                             TraceRecorder::Clock::now(), std::move(args));
+        }
+    }
+
+    /**
+     * @brief Adds a detail known once the step ran, e.g. its result.
+     */
+    void arg(const std::string& key, nlohmann::json value)
+    {
+        if (recorder != nullptr)
+        {
+            args[key] = std::move(value);
+        }
+    }
+
+  private:
+    TraceRecorder* const recorder;
+    const char* const category;
+    std::string name;
+    nlohmann::json args;
+    TraceRecorder::Clock::time_point begin;
+};
+
+} // namespace openpower::dump
@@ -0,0 +1,155 @@
+#include "worker_pool.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <exception>
+
+namespace openpower::dump
+{
+
+namespace
+{
+
+/** @brief The pool the calling thread works for, if any */
+thread_local const WorkerPool* currentPool = nullptr;
+
+/** @brief Index of the calling worker in its pool */
+thread_local size_t currentWorker = 0;
+
+} // namespace
+
+WorkerPool::WorkerPool(size_t workers)
+{
+    workers = std::max<size_t>(workers, 1);
+    for (size_t i = 0; i < workers; i++)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < workers; i++)
+    {
+        threads.emplace_back(&WorkerPool::run, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    wait();
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkerPool::submit(Task task)
+{
+    size_t index = 0;
+    {
+        std::lock_guard lock(mutex);
+        if (currentPool == this)
+        {
+            index = currentWorker;
+        }
+        else
+        {
+            index = nextQueue;
+            nextQueue = (nextQueue + 1) % queues.size();
+        }
+        pending++;
+
+        // Counted along with the push, so a worker never claims a task
+        // which is not queued yet
+        {
+            std::lock_guard queueLock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        queued++;
+    }
+    workAvailable.notify_one();
+}
+
+void WorkerPool::wait()
+{
+    std::unique_lock lock(mutex);
+    allDone.wait(lock, [this]() { return pending == 0; });
+}
+
+bool WorkerPool::takeTask(size_t index, Task& task)
+{
+    // Own queue first, newest task, then the oldest task of the others
+    for (size_t i = 0; i < queues.size(); i++)
+    {
+        auto& queue = *queues[(index + i) % queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty())
+        {
+            continue;
+        }
+        if (i == 0)
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+
+void WorkerPool::run(size_t index)
+{
+    currentPool = this;
+    currentWorker = index;
+
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock lock(mutex);
+            workAvailable.wait(lock,
+                               [this]() { return stopping || queued > 0; });
+            if (queued == 0)
+            {
+                return;
+            }
+            // Taken along with the count, so the scan cannot miss the task
+            // while other workers take theirs
+            takeTask(index, task);
+            queued--;
+        }
+
+        try
+        {
+            task();
+        }
+        catch (const std::exception& e)
+        {
+            lg2::error("Worker task failed: {ERROR}", "ERROR", e);
+        }
+        catch (...)
+        {
+            lg2::error("Worker task failed with an unknown exception");
+        }
+
+        bool idle = false;
+        {
+            std::lock_guard lock(mutex);
+            idle = (--pending == 0);
+        }
+        if (idle)
+        {
+            allDone.notify_all();
+        }
+    }
+}
+
+} // namespace openpower::dump
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openpower::dump
+{
+
+/**
+ * @class WorkerPool
+ * @brief A fixed set of worker threads executing submitted tasks.
+ *
+ * Every worker owns a task queue. A task submitted from a worker goes to
+ * the queue of that worker and is taken from the back, so a task is
+ * usually followed by the tasks it spawned. Idle workers steal from the
+ * front of the other queues. Tasks submitted from outside the pool are
+ * spread over the queues.
+ */
+class WorkerPool
+{
+  public:
+    using Task = std::function<void()>;
+
+    WorkerPool() = delete;
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param[in] workers - Number of worker threads, at least one is started
+     */
+    explicit WorkerPool(size_t workers);
+
+    /**
+     * @brief Waits for the submitted tasks and stops the worker threads.
+     */
+    ~WorkerPool();
+
+    /**
+     * @brief Queues a task for execution.
+     *
+     * Exceptions escaping the task are logged and dropped.
+     *
+     * @param[in] task - The task
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Blocks until every submitted task, including the tasks they
+     * submitted, has completed. Must not be called from a worker.
+     */
+    void wait();
+
+    /**
+     * @brief Returns the number of worker threads.
+     */
+    size_t size() const
+    {
+        return threads.size();
+    }
+
+  private:
+    /** @brief Task queue of a worker */
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /** @brief Task queues indexed by worker */
+    std::vector<std::unique_ptr<Queue>> queues;
+
+    /** @brief Worker threads */
+    std::vector<std::thread> threads;
+
+    /** @brief Protects the counters below */
+    std::mutex mutex;
+
+    /** @brief Signalled when a task is queued or the pool stops */
+    std::condition_variable workAvailable;
+
+    /** @brief Signalled when the last pending task completes */
+    std::condition_variable allDone;
+
+    /** @brief Tasks in the queues not claimed by a worker yet */
+    size_t queued = 0;
+
+    /** @brief Tasks submitted and not completed yet */
+    size_t pending = 0;
+
+    /** @brief Queue receiving the next task submitted from outside */
+    size_t nextQueue = 0;
+
+    /** @brief Set when the workers have to exit */
+    bool stopping = false;
+
+    /**
+     * @brief Main loop of a worker.
+     *
+     * @param[in] index - Index of the worker
+     */
+    void run(size_t index);
+
+    /**
+     * @brief Takes a task from the worker's own queue, or steals one from
+     * another worker. Called with the pool mutex held.
+     *
+     * @param[in] index - Index of the worker
+     * @param[out] task - The task taken
+     *
+     * @return true if a task was taken
+     */
+    bool takeTask(size_t index, Task& task);
+};
+
+} // namespace openpower::dump
@@ -1,20 +1,17 @@
 #pragma once
 
-#include "file_descriptor.hpp"
-#include "utils.hpp"
+#include "ffdc_buffer.hpp"
 #include "xyz/openbmc_project/Logging/Create/server.hpp"
 
 #include <nlohmann/json.hpp>
 
 #include <cstdint>
-#include <filesystem>
 
 namespace watchdog
 {
 namespace dump
 {
 
-namespace fs = std::filesystem;
 using FFDCFormat =
     sdbusplus::xyz::openbmc_project::Logging::server::Create::FFDCFormat;
 using FFDCTuple =
@@ -26,7 +23,8 @@ using ::nlohmann::json;
  *
  * File that contains FFDC (first failure data capture) data in json format.
  *
- * This class is used to store FFDC json callout data in an error log.
+ * This class is used to store FFDC json callout data in an error log. The
+ * file lives in memory, it has no path and nothing to clean up.
  */
 class FFDCFile
 {
@@ -37,7 +35,7 @@ class FFDCFile
     FFDCFile(FFDCFile&&) = default;
     FFDCFile& operator=(const FFDCFile&) = delete;
     FFDCFile& operator=(FFDCFile&&) = default;
-    ~FFDCFile();
+    ~FFDCFile() = default;
 
     /**
      * @brief Constructor
@@ -51,52 +49,23 @@ class FFDCFile
     /**
      * @brief Returns the file descriptor for the file.
      *
-     * @details The file is open for both reading and writing.
+     * @details The file is open for reading, positioned at the start of the
+     * data.
      *
      * @return file descriptor
      */
     int getFileDescriptor() const
     {
-        // Return the integer file descriptor within the FileDescriptor object
-        return descriptor();
-    }
-
-    /**
-     * @brief Returns the absolute path to the file.
-     *
-     * @return absolute path
-     */
-    const fs::path& getPath() const
-    {
-        return tempFile.getPath();
+        return buffer.getFileDescriptor();
     }
 
   private:
     /**
-     * @brief Temporary file where FFDC data is stored.
-     *
-     * @details The TemporaryFile destructor will automatically delete the file
-     * if it was not explicitly deleted using remove().
-     */
-    TemporaryFile tempFile{};
-
-    /**
-     * @brief File descriptor for reading from/writing to the file.
+     * @brief In-memory file where FFDC data is stored.
      *
-     * @details The FileDescriptor destructor will automatically close the file
-     * if it was not explicitly closed using remove().
-     */
-    FileDescriptor descriptor{};
-
-    /**
-     * @brief Used to store callout ffdc data from passed json object
-     */
-    std::string calloutData;
-
-    /**
-     * @brief Creates FFDC file for creating PEL records.
+     * @details The buffer destructor closes the file, which releases it.
      */
-    void prepareFFDCFile();
+    openpower::common::FFDCBuffer buffer;
 };
 
 } // namespace dump